@@ -0,0 +1,267 @@
+// Headless microbenchmarks for the simulation and mesh generation code.
+// Each case is timed over several repetitions and written as CSV:
+//   benchmark,param,value,reps,iterations,mean_us,median_us,stddev_us,min_us
+// Times are per call. Physics cases always simulate BENCH_TICKS ticks from the
+// same start, so every sweep point times the same stretch of motion.
+// Usage: bench_core [--reps N] [--out file.csv]
+// The memory report for each nest size goes to stderr, keeping the CSV plain.
+
+#include <raylib.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "hay.h"
+#include "egg.h"
+#include "terrarium.h"
+#include "arena.h"
+
+#define DEFAULT_REPS 10
+#define MAX_REPS 1000
+#define TARGET_WORK 2000000     // Straw (or vertex) visits per repetition, keeps reps ~1-10 ms
+#define BENCH_TICKS 90          // Physics ticks per repetition from the reset state: 3 s of fall, landing and settling
+#define BENCH_DELTA_TIME PHYSICS_STEP
+#define BENCH_SEED 1234
+
+typedef struct {
+    const char* name;
+    const char* param;
+    int value;
+    int iterations;     // Calls per repetition
+} BenchCase;
+
+typedef void (*BenchFunc)(void* data, int iterations);
+typedef void (*BenchReset)(void* data);
+
+static double GetTimeMicroseconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e6 + now.tv_nsec / 1e3;
+}
+
+static int CompareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int GetIterations(int workPerCall) {
+    int iterations = TARGET_WORK / (workPerCall > 0 ? workPerCall : 1);
+    return iterations > 0 ? iterations : 1;
+}
+
+// One untimed warm-up repetition, then reps timed ones. reset, if any, runs
+// untimed before each of them so every repetition starts from the same state.
+static void RunBenchmark(FILE* out, BenchCase bench, int reps, BenchFunc func, BenchReset reset, void* data) {
+    double samples[MAX_REPS];
+
+    if (reset != NULL) reset(data);
+    func(data, bench.iterations);
+    for (int r = 0; r < reps; r++) {
+        if (reset != NULL) reset(data);
+        double start = GetTimeMicroseconds();
+        func(data, bench.iterations);
+        samples[r] = (GetTimeMicroseconds() - start) / bench.iterations;
+    }
+
+    double sum = 0.0;
+    for (int r = 0; r < reps; r++) sum += samples[r];
+    double mean = sum / reps;
+
+    double variance = 0.0;
+    for (int r = 0; r < reps; r++) variance += (samples[r] - mean) * (samples[r] - mean);
+    double stddev = (reps > 1) ? sqrt(variance / (reps - 1)) : 0.0;
+
+    qsort(samples, reps, sizeof(double), CompareDoubles);
+    double median = (reps % 2 == 1) ? samples[reps / 2] : 0.5 * (samples[reps / 2 - 1] + samples[reps / 2]);
+
+    fprintf(out, "%s,%s,%d,%d,%d,%.4f,%.4f,%.4f,%.4f\n", bench.name, bench.param, bench.value,
+            reps, bench.iterations, mean, median, stddev, samples[0]);
+    fflush(out);
+}
+
+// Nest
+
+typedef struct {
+    MemArena arena;
+    HayPiece* hayPieces;
+    HayPiece* pristine;     // Copy of the fresh nest, restored before each repetition
+    int count;
+    CollisionSphere egg;
+} NestBench;
+
+static NestBench CreateNestBench(int count) {
+    NestBench bench = { .count = count };
+    SetRandomSeed(BENCH_SEED);
+    bench.arena = CreateArena((size_t)count * sizeof(HayPiece), MEMORY_NEST);
+    bench.hayPieces = InitializeNest(&bench.arena, count);
+    if (bench.hayPieces != NULL) {
+        bench.pristine = (HayPiece*)MemAlloc((unsigned int)((size_t)count * sizeof(HayPiece)));
+        memcpy(bench.pristine, bench.hayPieces, (size_t)count * sizeof(HayPiece));
+    }
+
+    // Resting in the middle of the nest, so straws take the compression path
+    bench.egg = (CollisionSphere){ .position = { 0.0f, NEST_HEIGHT * 0.8f, 0.0f }, .radius = 0.1f };
+    return bench;
+}
+
+static void DestroyNestBench(NestBench* bench) {
+    MemFree(bench->pristine);
+    DestroyArena(&bench->arena);
+}
+
+static void ResetNestBench(void* data) {
+    NestBench* bench = (NestBench*)data;
+    memcpy(bench->hayPieces, bench->pristine, (size_t)bench->count * sizeof(HayPiece));
+}
+
+static void BenchInitializeNest(void* data, int iterations) {
+    NestBench* bench = (NestBench*)data;
+    for (int i = 0; i < iterations; i++) {
+        ResetArena(&bench->arena);
+        InitializeNest(&bench->arena, bench->count);
+    }
+}
+
+static volatile int contactSink;
+
+static void BenchUpdateHayPhysics(void* data, int iterations) {
+    NestBench* bench = (NestBench*)data;
+    HayEgg egg = { .footprint = bench->egg };
+    for (int i = 0; i < iterations; i++) {
+        UpdateHayPhysics(bench->hayPieces, bench->count, &egg, 1, BENCH_DELTA_TIME);
+        contactSink = egg.contact.straws;
+    }
+}
+
+static volatile float heightSink;
+
+static void BenchCalculateHayHeight(void* data, int iterations) {
+    NestBench* bench = (NestBench*)data;
+    for (int i = 0; i < iterations; i++) {
+        heightSink = CalculateHayHeight(bench->egg.position, bench->hayPieces, bench->count);
+    }
+}
+
+// Eggs
+
+#define MAX_BENCH_EGGS MAX_PETS     // UpdateEggPhysics steps up to the pets pool
+
+typedef struct {
+    NestBench nest;
+    MemPool pets;
+    EggSystem eggs[MAX_BENCH_EGGS];
+    int eggCount;
+} EggBench;
+
+static void ResetEggBench(void* data) {
+    EggBench* bench = (EggBench*)data;
+    ResetNestBench(&bench->nest);
+
+    // Drop every egg from the same place each repetition, spread over the nest
+    for (int e = 0; e < bench->eggCount; e++) {
+        float angle = 2.0f * PI * e / bench->eggCount;
+        SpawnEgg(&bench->eggs[e], &bench->pets, 0);
+        bench->eggs[e].egg->position.x = 0.5f * NEST_RADIUS * sinf(angle);
+        bench->eggs[e].egg->position.z = 0.5f * NEST_RADIUS * cosf(angle);
+    }
+}
+
+static void BenchUpdateEggPhysics(void* data, int iterations) {
+    EggBench* bench = (EggBench*)data;
+    for (int i = 0; i < iterations; i++) {
+        UpdateEggPhysics(bench->eggs, bench->eggCount, bench->nest.hayPieces, bench->nest.count, BENCH_DELTA_TIME);
+    }
+}
+
+// Ground mesh
+
+typedef struct {
+    int rings;
+    int slices;
+} GroundBench;
+
+static void FreeMeshData(Mesh* mesh) {
+    // The mesh was never uploaded, UnloadMesh would need a GL context
+    MemFree(mesh->vertices);
+    MemFree(mesh->texcoords);
+    MemFree(mesh->normals);
+    MemFree(mesh->indices);
+}
+
+static void BenchGenerateGroundMesh(void* data, int iterations) {
+    GroundBench* bench = (GroundBench*)data;
+    for (int i = 0; i < iterations; i++) {
+        Mesh mesh = GenerateGroundMesh(2.0f, bench->rings, bench->slices);
+        FreeMeshData(&mesh);
+    }
+}
+
+int main(int argc, char** argv) {
+    int reps = DEFAULT_REPS;
+    const char* outPath = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        }
+    }
+    if (reps < 1) reps = 1;
+    if (reps > MAX_REPS) reps = MAX_REPS;
+
+    FILE* out = (outPath != NULL) ? fopen(outPath, "w") : stdout;
+    if (out == NULL) {
+        fprintf(stderr, "bench_core: can't open %s\n", outPath);
+        return 1;
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    fprintf(out, "benchmark,param,value,reps,iterations,mean_us,median_us,stddev_us,min_us\n");
+
+    const int strawCounts[] = { NUM_NEST_PIECES, 10000, 100000, 1000000 };
+    for (int i = 0; i < (int)(sizeof(strawCounts) / sizeof(strawCounts[0])); i++) {
+        int count = strawCounts[i];
+        NestBench nest = CreateNestBench(count);
+        if (nest.hayPieces == NULL) {
+            DestroyNestBench(&nest);
+            continue;
+        }
+
+        BenchCase init = { "InitializeNest", "straws", count, GetIterations(count * 10) };
+        RunBenchmark(out, init, reps, BenchInitializeNest, NULL, &nest);
+        BenchCase update = { "UpdateHayPhysics", "straws", count, BENCH_TICKS };
+        RunBenchmark(out, update, reps, BenchUpdateHayPhysics, ResetNestBench, &nest);
+        BenchCase height = { "CalculateHayHeight", "straws", count, GetIterations(count) };
+        RunBenchmark(out, height, reps, BenchCalculateHayHeight, NULL, &nest);
+
+        fprintf(stderr, "Memory with %d straws\n", count);
+        PrintMemoryReport(stderr, "  ");
+        DestroyNestBench(&nest);
+    }
+
+    const int eggCounts[] = { 1, 2, 4, MAX_BENCH_EGGS };
+    for (int i = 0; i < (int)(sizeof(eggCounts) / sizeof(eggCounts[0])); i++) {
+        EggBench eggs = { .nest = CreateNestBench(NUM_NEST_PIECES), .eggCount = eggCounts[i] };
+        eggs.pets = CreatePool(sizeof(PhysicsObject), MAX_BENCH_EGGS, MEMORY_PETS);
+
+        // One nest step per tick, each straw checked against every egg
+        BenchCase update = { "UpdateEggPhysics", "eggs", eggs.eggCount, BENCH_TICKS };
+        RunBenchmark(out, update, reps, BenchUpdateEggPhysics, ResetEggBench, &eggs);
+
+        DestroyNestBench(&eggs.nest);
+        DestroyPool(&eggs.pets);
+    }
+
+    const int ringCounts[] = { 8, 16, GROUND_RINGS, 64, 128 };
+    for (int i = 0; i < (int)(sizeof(ringCounts) / sizeof(ringCounts[0])); i++) {
+        GroundBench ground = { ringCounts[i], ringCounts[i] };
+        int vertices = (ground.rings / 2 + 1) * (ground.slices + 1);
+        BenchCase generate = { "GenerateGroundMesh", "rings_slices", ground.rings, GetIterations(vertices) };
+        RunBenchmark(out, generate, reps, BenchGenerateGroundMesh, NULL, &ground);
+    }
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
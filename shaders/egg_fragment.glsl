@@ -17,6 +17,8 @@ uniform vec3 cameraUp;
 uniform vec3 color;
 uniform int shaderType;
 
+#include "point_lights.glsl"
+
 // Enhanced noise functions
 float hash(float n) { 
     return fract(sin(n) * 753.5453123); 
@@ -53,6 +55,7 @@ float fbm(vec3 p) {
     }
     return value;
 }
+
 vec3 getBaseColor(int colorType, float variation) {
     // Base colors with variation
     switch(colorType) {
@@ -224,6 +227,7 @@ void main() {
     outColor += accentColor * rim * 0.5;
 
     outColor *= (0.6 + 0.4 * diff);
+    outColor += outColor * pointLights(fragPosition, normal) * 0.25;
     outColor *= 0.8 + 0.2 * pulse1;
 
     float overallPulse = 0.95 + 0.05 * sin(iTime * 0.3);
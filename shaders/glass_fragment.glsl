@@ -3,7 +3,10 @@
 in vec3 fragPosition;
 in vec3 fragNormal;
 in vec2 fragTexCoord;
-out vec4 finalColor;
+
+// Weighted blended OIT targets, see oit.h
+layout(location = 0) out vec4 accumColor;
+layout(location = 1) out vec4 revealColor;
 
 uniform vec4 albedoColor;
 uniform vec4 edgeColor;
@@ -11,11 +14,10 @@ uniform float roughnessValue;
 uniform float normalStrength;
 uniform vec3 lightDir;
 uniform vec3 viewPos;
-uniform vec3 internalLightPos;
-uniform vec3 internalLightColor;
-uniform float internalLightIntensity;
 uniform samplerCube environmentMap;
 
+#include "point_lights.glsl"
+
 const float IOR = 1.15;
 const float F0 = 0.008;
 const float TRANSPARENCY = 1.0;
@@ -37,20 +39,13 @@ void main() {
     }
     vec3 reflectDir = reflect(-V, N);
 
-    vec3 toLight = internalLightPos - fragPosition;
-    vec3 internalL = normalize(toLight);
-    float internalDist = length(toLight);
-    float internalAttenuation = exp(-internalDist * 0.1);
-
     float NdotV = max(dot(N, V), 0.0);
     float NdotL = max(dot(N, L), 0.0);
     float NdotH = max(dot(N, H), 0.0);
-    float NdotIntL = max(dot(N, internalL), 0.0);
 
     float fresnel = fresnelSchlick(NdotV) * 0.3;
     float edge = pow(1.0 - NdotV, EDGE_STRENGTH) * (1.0 - fresnel) * 0.3;
     float specular = pow(max(dot(N, H), 0.0), 24.0) * fresnel;
-    float internalSpecular = pow(max(dot(N, normalize(internalL + refractDir)), 0.0), 24.0) * (1.0 - fresnel);
 
     // Very subtle base color to preserve transparency
     vec3 baseColor = mix(albedoColor.rgb, vec3(1.0), 0.1);
@@ -59,13 +54,26 @@ void main() {
     // Minimal edge highlighting
     color += edge * edgeColor.rgb * EDGE_STRENGTH * 0.03;
 
-    // Subtle internal lighting
-    vec3 internalContribution = internalLightColor * internalLightIntensity * 
-                               NdotIntL * internalAttenuation * 1.5;
-
-    // Very soft caustics
-    float caustic = pow(max(dot(refractDir, internalL), 0.0), 48.0) * internalAttenuation;
-    color += internalLightColor * caustic * internalLightIntensity * 0.1;
+    // Subtle internal lighting and very soft caustics from the lights in this tile
+    vec3 internalContribution = vec3(0.0);
+    ivec2 tileLights = getTileLights();
+    for (int i = 0; i < tileLights.y; i++) {
+        int index = getLightIndex(tileLights.x + i);
+        vec4 positionRange = texelFetch(lightData, ivec2(index, 0), 0);
+        vec4 colorIntensity = texelFetch(lightData, ivec2(index, 1), 0);
+
+        vec3 toLight = positionRange.xyz - fragPosition;
+        float internalDist = length(toLight);
+        vec3 internalL = toLight / internalDist;
+        float internalAttenuation = exp(-internalDist * 0.1) * lightWindow(internalDist, positionRange.w);
+        vec3 radiance = colorIntensity.rgb * colorIntensity.a * internalAttenuation;
+
+        float NdotIntL = max(dot(N, internalL), 0.0);
+        internalContribution += radiance * NdotIntL * 1.5;
+
+        float caustic = pow(max(dot(refractDir, internalL), 0.0), 48.0);
+        color += radiance * caustic * 0.1;
+    }
 
     // Minimal environment reflection
     vec3 reflection = reflect(-V, N);
@@ -90,5 +98,12 @@ void main() {
     opacity += specular * 0.01;
     opacity = clamp(opacity, 0.01, 0.1);
 
-    finalColor = vec4(color, opacity);
+    // McGuire & Bavoil's view-depth weight (eq. 7), using the distance to the eye
+    float z = length(viewPos - fragPosition);
+    float weight = opacity * clamp(10.0 / (1e-5 + pow(z / 5.0, 2.0) + pow(z / 200.0, 6.0)), 1e-2, 3e3);
+
+    // Color is already premultiplied, as with the BLEND_ALPHA_PREMULTIPLY it replaced.
+    // The composite divides by the summed alpha * weight.
+    accumColor = vec4(color * weight, opacity);
+    revealColor = vec4(opacity * weight, 0.0, 0.0, opacity);
 }
\ No newline at end of file
@@ -4,6 +4,8 @@ in vec3 fragNormal;
 in vec2 fragTexCoord;
 out vec4 finalColor;
 
+#include "point_lights.glsl"
+
 float rand(vec2 co) {
     return fract(sin(dot(co.xy, vec2(12.9898, 78.233))) * 43758.5453);
 }
@@ -24,5 +26,8 @@ void main() {
     float diff = max(dot(fragNormal, lightDir), 0.2);
     float ambient = 0.3;
 
-    finalColor = vec4(groundColor * (diff + ambient), 1.0);
+    vec3 lit = groundColor * (diff + ambient);
+    lit += groundColor * pointLights(fragPosition, normalize(fragNormal)) * 0.25;
+
+    finalColor = vec4(lit, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,12 @@
+#version 330
+
+in vec3 fragColor;
+in float fragSide;      // -1 to 1 across the ribbon
+
+out vec4 finalColor;
+
+void main() {
+    // Shade the flat ribbon like the round straw it stands in for
+    float facing = sqrt(max(1.0 - fragSide*fragSide, 0.0));
+    finalColor = vec4(fragColor*(0.6 + 0.4*facing), 1.0);
+}
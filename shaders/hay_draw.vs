@@ -0,0 +1,46 @@
+#version 330
+
+// Instanced: one instance per straw, drawn as a triangle strip ribbon with two
+// vertices per curve segment point, turned to face the camera
+layout(location = 0) in vec3 restPosition;     // Normalized within the nest bounds
+layout(location = 1) in vec3 endOffset;        // Quantized offsets from the start point
+layout(location = 2) in vec3 controlOffset;
+layout(location = 3) in uint strawColor;       // RGB565
+layout(location = 4) in vec2 springState;      // x: compression, y: its velocity
+layout(location = 5) in float strawRadius;     // Normalized, 1 is maxRadius
+
+uniform mat4 mvp;
+uniform vec3 cameraPosition;
+uniform vec3 boundsMin;
+uniform vec3 boundsMax;
+uniform float offsetScale;
+uniform float maxRadius;
+uniform float maxCompression;
+uniform float renderAhead;      // Time since the last step, see DrawHayPiece
+uniform int segments;
+
+out vec3 fragColor;
+out float fragSide;
+
+void main() {
+    vec3 start = mix(boundsMin, boundsMax, restPosition);
+    start.y -= clamp(springState.x + renderAhead*springState.y, 0.0, maxCompression);
+    vec3 end = start + endOffset*offsetScale;
+    vec3 control = start + controlOffset*offsetScale;
+
+    // Quadratic bezier, as in DrawHayPiece
+    float t = float(gl_VertexID/2)/float(segments - 1);
+    float s = 1.0 - t;
+    vec3 position = s*s*start + 2.0*s*t*control + t*t*end;
+    vec3 tangent = 2.0*s*(control - start) + 2.0*t*(end - control);
+
+    // Widen across the curve, perpendicular to the view direction
+    vec3 across = cross(tangent, cameraPosition - position);
+    float acrossLength = length(across);
+    float side = ((gl_VertexID & 1) == 0) ? -1.0 : 1.0;
+    if (acrossLength > 0.0) position += across/acrossLength*side*strawRadius*maxRadius;
+
+    fragColor = vec3((strawColor >> 11u) & 31u, (strawColor >> 5u) & 63u, strawColor & 31u)/vec3(31.0, 63.0, 31.0);
+    fragSide = side;
+    gl_Position = mvp*vec4(position, 1.0);
+}
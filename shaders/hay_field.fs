@@ -0,0 +1,10 @@
+#version 330
+
+in vec2 strawState;
+
+out vec4 finalColor;
+
+void main() {
+    // r: sum of compression, g: sum of its velocity
+    finalColor = vec4(strawState, 0.0, 0.0);
+}
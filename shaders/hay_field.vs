@@ -0,0 +1,16 @@
+#version 330
+
+// One point per straw, summed additively into the grid cell under its start point
+layout(location = 0) in vec3 restPosition;     // Normalized within the nest bounds
+layout(location = 4) in vec2 springState;      // x: compression, y: its velocity
+
+uniform float fieldSize;
+
+out vec2 strawState;
+
+void main() {
+    strawState = springState;
+
+    vec2 cell = min(floor(restPosition.xz*fieldSize), vec2(fieldSize - 1.0));
+    gl_Position = vec4((cell + 0.5)/fieldSize*2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,53 @@
+#version 330
+
+// One vertex per straw. The new spring state is captured with transform
+// feedback, nothing is rasterized.
+layout(location = 0) in vec3 restPosition;     // Normalized within the nest bounds
+layout(location = 4) in vec2 springState;      // x: compression, y: its velocity
+
+#define MAX_EGGS 4
+
+uniform vec3 boundsMin;
+uniform vec3 boundsMax;
+uniform vec4 eggs[MAX_EGGS];    // xyz: bottom of the egg, w: footprint radius
+uniform int eggCount;
+uniform float deltaTime;
+uniform float maxCompression;
+uniform float stiffness;
+uniform float damping;
+uniform float strawMass;
+
+out vec2 outState;
+
+void main() {
+    vec3 rest = mix(boundsMin, boundsMax, restPosition);
+
+    // Same rule as UpdateHayPhysics: the egg bottom holds straws under it down
+    // to its surface, weighted by how close they are to the footprint center
+    float target = 0.0;
+    for (int i = 0; i < eggCount; i++) {
+        vec3 egg = eggs[i].xyz;
+        float radius = eggs[i].w;
+        float distance = length(rest.xz - egg.xz);
+
+        if (distance < radius) {
+            float weight = 1.0 - distance/radius;
+            target = max(target, clamp(weight*(rest.y - egg.y), 0.0, maxCompression));
+        }
+    }
+
+    // Backward Euler spring-damper toward rest, stable for any step
+    float compression = springState.x;
+    float dt = deltaTime;
+    float velocity = (springState.y - dt*stiffness*compression/strawMass) /
+                     (1.0 + dt*damping/strawMass + dt*dt*stiffness/strawMass);
+    if (compression + dt*velocity < target) {
+        velocity = (target - compression)/dt;
+        compression = target;
+    } else {
+        compression += dt*velocity;
+    }
+
+    if (compression <= 0.0 || compression >= maxCompression) velocity = 0.0;
+    outState = vec2(clamp(compression, 0.0, maxCompression), velocity);
+}
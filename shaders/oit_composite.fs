@@ -0,0 +1,21 @@
+#version 330
+
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+out vec4 finalColor;
+
+uniform sampler2D texture0;         // Accumulation: sum of premultiplied color * weight
+uniform sampler2D revealTexture;    // r: sum of alpha * weight, a: revealage
+
+void main() {
+    vec4 accum = texture(texture0, fragTexCoord);
+    vec4 reveal = texture(revealTexture, fragTexCoord);
+
+    // Nothing translucent covers this pixel
+    if (reveal.a >= 1.0) discard;
+
+    // Weighted average color, blended over the opaque scene by total coverage
+    vec3 averageColor = accum.rgb / max(reveal.r, 1e-5);
+    finalColor = vec4(averageColor, 1.0 - reveal.a);
+}
@@ -0,0 +1,46 @@
+// Tiled point lights, see light.c. Spliced into fragment shaders at load time
+// in place of their #include "point_lights.glsl" line.
+uniform sampler2D lightData;      // Per light: (position, range), (color, intensity)
+uniform sampler2D lightGrid;      // Per screen tile: (first index, count)
+uniform sampler2D lightIndices;
+uniform int lightTileSize;
+uniform int lightIndexWidth;      // Width of lightIndices in texels
+
+// First index slot and light count of this fragment's screen tile
+ivec2 getTileLights() {
+    ivec2 tile = ivec2(gl_FragCoord.xy) / lightTileSize;
+    tile = min(tile, textureSize(lightGrid, 0) - 1);
+    return ivec2(texelFetch(lightGrid, tile, 0).xy);
+}
+
+int getLightIndex(int slot) {
+    ivec2 texel = ivec2(slot % lightIndexWidth, slot / lightIndexWidth);
+    return int(texelFetch(lightIndices, texel, 0).r);
+}
+
+// Smoothly reaches zero at the light's range
+float lightWindow(float dist, float range) {
+    float r = dist / range;
+    r *= r;
+    float w = clamp(1.0 - r * r, 0.0, 1.0);
+    return w * w;
+}
+
+// Diffuse light from the point lights in this fragment's screen tile
+vec3 pointLights(vec3 position, vec3 normal) {
+    ivec2 tileLights = getTileLights();
+
+    vec3 result = vec3(0.0);
+    for (int i = 0; i < tileLights.y; i++) {
+        int index = getLightIndex(tileLights.x + i);
+        vec4 positionRange = texelFetch(lightData, ivec2(index, 0), 0);
+        vec4 colorIntensity = texelFetch(lightData, ivec2(index, 1), 0);
+
+        vec3 toLight = positionRange.xyz - position;
+        float dist = length(toLight);
+        float attenuation = lightWindow(dist, positionRange.w) / (1.0 + dist * dist);
+
+        result += colorIntensity.rgb * colorIntensity.a * attenuation * max(dot(normal, toLight / dist), 0.0);
+    }
+    return result;
+}
@@ -16,6 +16,9 @@ pkgs.mkShell {
     export CFLAGS="-Wall -I${pkgs.raylib}/include"
     export LIBS="-lraylib -lGL -lm -lpthread -ldl -lrt -lX11"
 
+    # pkgs.raylib has no glad.h, so the GPU hay links GL from mesa. For raylib's
+    # own loader instead, run: make RAYLIB_SRC=/path/to/raylib/src
+
     # Create necessary directories if they don't exist
     mkdir -p src build bin
 
@@ -0,0 +1,152 @@
+#include "arena.h"
+#include <stdlib.h>
+
+static MemoryReport memoryReport = {0};
+
+static const char* subsystemNames[MEMORY_SUBSYSTEM_COUNT] = {
+    "Nest", "Pets", "Terrarium", "Lights", "Render", "Frame"
+};
+
+MemArena CreateArena(size_t capacity, MemorySubsystem subsystem) {
+    MemArena arena = {0};
+    arena.base = (unsigned char*)malloc(capacity);
+    arena.capacity = (arena.base != NULL) ? capacity : 0;
+    arena.subsystem = subsystem;
+
+    if (arena.base == NULL) {
+        TraceLog(LOG_ERROR, "ARENA: Failed to reserve %zu bytes for %s", capacity, subsystemNames[subsystem]);
+    }
+    TrackCpuMemory(subsystem, arena.capacity);
+    return arena;
+}
+
+void* ArenaAlloc(MemArena* arena, size_t size) {
+    // malloc returns suitably aligned memory, so aligning the offset is enough
+    size_t offset = (arena->used + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (offset + size > arena->capacity) {
+        TraceLog(LOG_WARNING, "ARENA: %s arena out of memory (%zu of %zu bytes used, %zu requested)",
+                 subsystemNames[arena->subsystem], arena->used, arena->capacity, size);
+        return NULL;
+    }
+
+    arena->used = offset + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return arena->base + offset;
+}
+
+void ResetArena(MemArena* arena) {
+    arena->used = 0;
+}
+
+void DestroyArena(MemArena* arena) {
+    memoryReport.cpuBytes[arena->subsystem] -= arena->capacity;
+    free(arena->base);
+    *arena = (MemArena){0};
+}
+
+MemPool CreatePool(size_t blockSize, int capacity, MemorySubsystem subsystem) {
+    MemPool pool = {0};
+
+    // Every block must hold the free list link and keep the next block aligned
+    if (blockSize < sizeof(void*)) blockSize = sizeof(void*);
+    blockSize = (blockSize + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+    pool.base = (unsigned char*)malloc(blockSize * capacity);
+    pool.blockSize = blockSize;
+    pool.capacity = (pool.base != NULL) ? capacity : 0;
+    pool.subsystem = subsystem;
+
+    if (pool.base == NULL) {
+        TraceLog(LOG_ERROR, "ARENA: Failed to reserve %d blocks for %s", capacity, subsystemNames[subsystem]);
+    }
+    for (int i = pool.capacity - 1; i >= 0; i--) {
+        void* block = pool.base + i * blockSize;
+        *(void**)block = pool.freeList;
+        pool.freeList = block;
+    }
+    TrackCpuMemory(subsystem, blockSize * pool.capacity);
+    return pool;
+}
+
+void* PoolAlloc(MemPool* pool) {
+    if (pool->freeList == NULL) {
+        TraceLog(LOG_WARNING, "ARENA: %s pool out of blocks (%d in use)", subsystemNames[pool->subsystem], pool->used);
+        return NULL;
+    }
+
+    void* block = pool->freeList;
+    pool->freeList = *(void**)block;
+    pool->used++;
+    if (pool->used > pool->peak) pool->peak = pool->used;
+    return block;
+}
+
+void PoolFree(MemPool* pool, void* block) {
+    if (block == NULL) return;
+    *(void**)block = pool->freeList;
+    pool->freeList = block;
+    pool->used--;
+}
+
+void DestroyPool(MemPool* pool) {
+    memoryReport.cpuBytes[pool->subsystem] -= pool->blockSize * pool->capacity;
+    free(pool->base);
+    *pool = (MemPool){0};
+}
+
+void TrackCpuMemory(MemorySubsystem subsystem, size_t bytes) {
+    memoryReport.cpuBytes[subsystem] += bytes;
+}
+
+void TrackGpuMemory(MemorySubsystem subsystem, size_t bytes) {
+    memoryReport.gpuBytes[subsystem] += bytes;
+}
+
+size_t GetMeshDataSize(Mesh mesh) {
+    size_t vertices = (size_t)mesh.vertexCount;
+    size_t bytes = 0;
+
+    if (mesh.vertices != NULL) bytes += vertices * 3 * sizeof(float);
+    if (mesh.texcoords != NULL) bytes += vertices * 2 * sizeof(float);
+    if (mesh.texcoords2 != NULL) bytes += vertices * 2 * sizeof(float);
+    if (mesh.normals != NULL) bytes += vertices * 3 * sizeof(float);
+    if (mesh.tangents != NULL) bytes += vertices * 4 * sizeof(float);
+    if (mesh.colors != NULL) bytes += vertices * 4 * sizeof(unsigned char);
+    if (mesh.indices != NULL) bytes += (size_t)mesh.triangleCount * 3 * sizeof(unsigned short);
+    return bytes;
+}
+
+void TrackModelMemory(MemorySubsystem subsystem, Model model) {
+    // raylib keeps the vertex arrays in RAM after uploading them to VBOs
+    for (int i = 0; i < model.meshCount; i++) {
+        size_t bytes = GetMeshDataSize(model.meshes[i]);
+        TrackCpuMemory(subsystem, bytes);
+        TrackGpuMemory(subsystem, bytes);
+    }
+}
+
+void TrackTextureMemory(MemorySubsystem subsystem, Texture2D texture) {
+    TrackGpuMemory(subsystem, (size_t)GetPixelDataSize(texture.width, texture.height, texture.format));
+}
+
+MemoryReport GetMemoryReport(void) {
+    return memoryReport;
+}
+
+const char* GetMemorySubsystemName(MemorySubsystem subsystem) {
+    return subsystemNames[subsystem];
+}
+
+void PrintMemoryReport(FILE* out, const char* linePrefix) {
+    size_t totalCpu = 0;
+    size_t totalGpu = 0;
+
+    fprintf(out, "%s%-10s %12s %12s\n", linePrefix, "Memory", "CPU bytes", "GPU bytes");
+    for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++) {
+        fprintf(out, "%s%-10s %12zu %12zu\n", linePrefix, subsystemNames[i],
+                memoryReport.cpuBytes[i], memoryReport.gpuBytes[i]);
+        totalCpu += memoryReport.cpuBytes[i];
+        totalGpu += memoryReport.gpuBytes[i];
+    }
+    fprintf(out, "%s%-10s %12zu %12zu\n", linePrefix, "Total", totalCpu, totalGpu);
+}
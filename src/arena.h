@@ -0,0 +1,77 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <raylib.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define ARENA_ALIGNMENT 16
+#define FRAME_ARENA_SIZE (64 * 1024)
+
+typedef enum {
+    MEMORY_NEST,
+    MEMORY_PETS,
+    MEMORY_TERRARIUM,
+    MEMORY_LIGHTS,
+    MEMORY_RENDER,
+    MEMORY_FRAME,
+    MEMORY_SUBSYSTEM_COUNT
+} MemorySubsystem;
+
+// Linear allocator: allocations are released all at once by ResetArena
+typedef struct {
+    unsigned char* base;
+    size_t capacity;
+    size_t used;
+    size_t peak;        // Highest `used` since creation
+    MemorySubsystem subsystem;
+} MemArena;
+
+typedef struct {
+    size_t cpuBytes[MEMORY_SUBSYSTEM_COUNT];
+    size_t gpuBytes[MEMORY_SUBSYSTEM_COUNT];    // Estimated VBO/texture/renderbuffer bytes
+} MemoryReport;
+
+// Fixed-size block allocator: blocks are taken and returned one at a time
+typedef struct {
+    unsigned char* base;
+    size_t blockSize;
+    int capacity;       // In blocks
+    int used;
+    int peak;           // Highest `used` since creation
+    void* freeList;     // Free blocks, linked through their first bytes
+    MemorySubsystem subsystem;
+} MemPool;
+
+// Reserve capacity bytes, counted as CPU memory of subsystem
+MemArena CreateArena(size_t capacity, MemorySubsystem subsystem);
+
+// Allocate from the arena, ARENA_ALIGNMENT aligned. Returns NULL when the arena is full.
+void* ArenaAlloc(MemArena* arena, size_t size);
+
+void ResetArena(MemArena* arena);
+void DestroyArena(MemArena* arena);
+
+// Reserve capacity blocks of blockSize bytes, counted as CPU memory of subsystem
+MemPool CreatePool(size_t blockSize, int capacity, MemorySubsystem subsystem);
+
+// Take a block from the pool, ARENA_ALIGNMENT aligned. Returns NULL when the pool is empty.
+void* PoolAlloc(MemPool* pool);
+void PoolFree(MemPool* pool, void* block);
+void DestroyPool(MemPool* pool);
+
+// Memory accounting. Resources are loaded once and live for the whole session.
+void TrackCpuMemory(MemorySubsystem subsystem, size_t bytes);
+void TrackGpuMemory(MemorySubsystem subsystem, size_t bytes);
+void TrackModelMemory(MemorySubsystem subsystem, Model model);      // CPU copy + VBOs
+void TrackTextureMemory(MemorySubsystem subsystem, Texture2D texture);
+
+size_t GetMeshDataSize(Mesh mesh);
+
+MemoryReport GetMemoryReport(void);
+const char* GetMemorySubsystemName(MemorySubsystem subsystem);
+
+// One line per subsystem plus a total, each starting with linePrefix
+void PrintMemoryReport(FILE* out, const char* linePrefix);
+
+#endif // ARENA_H
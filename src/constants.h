@@ -4,6 +4,8 @@
 // Physics constants
 #define GRAVITY 9.81f
 #define GROUND_Y 0.0f
+#define PHYSICS_STEP (1.0f / 30.0f)     // Fixed simulation tick, rendering interpolates between ticks
+#define MAX_PHYSICS_STEPS 5             // Per frame, so a long stall doesn't snowball
 #define NUM_COLORS 9
 #define MODEL_SCALE 10.0f
 
@@ -3,70 +3,122 @@
 #include <stdlib.h>
 #include "egg.h"
 #include "hay.h"
+#include "arena.h"
 
 EggSystem InitializeEggSystem(Shader shader) {
     EggSystem eggSystem = { 0 };
     eggSystem.model = LoadModel("assets/egg.glb");
     eggSystem.model.transform = MatrixScale(MODEL_SCALE, MODEL_SCALE, MODEL_SCALE);
+    TrackModelMemory(MEMORY_PETS, eggSystem.model);
 
     for (int i = 0; i < eggSystem.model.materialCount; i++) {
         eggSystem.model.materials[i].shader = shader;
     }
 
     eggSystem.numColors = NUM_COLORS;
-    eggSystem.egg.active = false;
+    eggSystem.egg = NULL;
 
     return eggSystem;
 }
-void SpawnEgg(EggSystem* eggSystem, int colorType) {
-    eggSystem->egg = (PhysicsObject){
+void SpawnEgg(EggSystem* eggSystem, MemPool* pets, int colorType) {
+    if (eggSystem->egg == NULL) {
+        eggSystem->egg = (PhysicsObject*)PoolAlloc(pets);
+        if (eggSystem->egg == NULL) return;
+    }
+
+    *eggSystem->egg = (PhysicsObject){
         .position = (Vector3){ 0.0f, 2.0f, 0.0f },
+        .previousPosition = (Vector3){ 0.0f, 2.0f, 0.0f },
+        .renderPosition = (Vector3){ 0.0f, 2.0f, 0.0f },
         .velocity = (Vector3){ 0.0f, 0.0f, 0.0f },
         .isGrounded = false,
         .colorType = colorType, // Use the provided colorType instead of random
-        .active = true
     };
 }
-void UpdateEggPhysics(EggSystem* eggSystem, HayPiece* hayPieces, float deltaTime) {
-    if (!eggSystem->egg.active) return;
+static CollisionSphere GetEggFootprint(const PhysicsObject* egg) {
+    return (CollisionSphere){ .position = egg->position, .radius = EGG_FOOTPRINT_RADIUS };
+}
 
-    CollisionSphere eggSphere = {
-        .position = eggSystem->egg.position,
-        .radius = 0.1f
-    };
+static HayEgg GetHayEgg(const PhysicsObject* egg) {
+    return (HayEgg){ .footprint = GetEggFootprint(egg), .velocity = egg->velocity.y };
+}
+
+// Fall onto the straws, whichever nest representation stepped them. The egg
+// falls freely until it reaches the first straw top, then the straws it presses
+// on move with it, so their mass, springs and dampers join the egg's backward
+// Euler step over the time t left:
+//   v1 = (m*v - P + t*(F - m*g)) / (m + M + t*C + t^2*K)
+// The egg settles without bouncing where the straw springs hold m*g, at any tick rate.
+static void UpdateEggMotion(PhysicsObject* egg, HayContact contact, float deltaTime) {
+    const float m = EGG_MASS;
+    float fall = contact.impactTime;
+    float y = egg->position.y + fall * (egg->velocity.y - 0.5f * GRAVITY * fall);
+    float v = egg->velocity.y - GRAVITY * fall;
+
+    if (contact.straws > 0) {
+        float t = deltaTime - fall;
+        v = (m * v - contact.momentum + t * (contact.force - m * GRAVITY)) /
+            (m + contact.mass + t * contact.damping + t * t * contact.stiffness);
+        y += t * v;
+    }
+
+    egg->velocity.y = v;
+    egg->position.y = y;
+    egg->isGrounded = contact.straws > 0;
+
+    if (egg->position.y < GROUND_Y) {
+        egg->position.y = GROUND_Y;
+        egg->velocity.y = fmaxf(egg->velocity.y, 0.0f);
+        egg->isGrounded = true;
+    }
+}
 
-    if (!eggSystem->egg.isGrounded) {
-        eggSystem->egg.velocity.y -= GRAVITY * deltaTime;
-        eggSystem->egg.position.y += eggSystem->egg.velocity.y * deltaTime;
-
-        float hayHeight = CalculateHayHeight(eggSystem->egg.position, hayPieces);
-        if (eggSystem->egg.position.y <= hayHeight) {
-            eggSystem->egg.position.y = hayHeight;
-            if (fabsf(eggSystem->egg.velocity.y) > 0.1f) {
-                eggSystem->egg.velocity.y *= -0.3f;
-            } else {
-                eggSystem->egg.velocity.y = 0;
-                eggSystem->egg.isGrounded = true;
-            }
-        }
-    } else {
-        float hayHeight = CalculateHayHeight(eggSystem->egg.position, hayPieces);
-        eggSystem->egg.position.y = hayHeight;
-        eggSystem->egg.velocity.y = 0;
+// Straws are stepped once against every egg where it is now, which also gives
+// the springs each egg meets this tick, then the eggs move. Drawing carries the
+// straws forward to the interpolated eggs, see DrawHayPiece.
+void UpdateEggPhysics(EggSystem* eggSystems, int eggCount, HayPiece* hayPieces, int hayCount, float deltaTime) {
+    PhysicsObject* eggs[MAX_PETS];
+    HayEgg hayEggs[MAX_PETS];
+    int count = 0;
+
+    for (int i = 0; i < eggCount && count < MAX_PETS; i++) {
+        PhysicsObject* egg = eggSystems[i].egg;
+        if (egg == NULL) continue;
+
+        egg->previousPosition = egg->position;
+        eggs[count] = egg;
+        hayEggs[count++] = GetHayEgg(egg);
     }
 
-    UpdateHayPhysics(hayPieces, eggSphere, deltaTime);
+    UpdateHayPhysics(hayPieces, hayCount, hayEggs, count, deltaTime);
+    for (int i = 0; i < count; i++) UpdateEggMotion(eggs[i], hayEggs[i].contact, deltaTime);
+}
+
+void UpdateEggPhysicsGpu(EggSystem* eggSystem, GpuNest* nest, float deltaTime) {
+    PhysicsObject* egg = eggSystem->egg;
+    if (egg == NULL) return;
+
+    egg->previousPosition = egg->position;
+    HayEgg hayEgg = GetHayEgg(egg);
+    UpdateGpuNest(nest, &hayEgg.footprint, 1, deltaTime);
+    UpdateEggMotion(egg, GatherGpuNestContact(nest, &hayEgg, deltaTime), deltaTime);
+}
+
+void InterpolateEgg(EggSystem* eggSystem, float alpha) {
+    PhysicsObject* egg = eggSystem->egg;
+    if (egg == NULL) return;
+    egg->renderPosition = Vector3Lerp(egg->previousPosition, egg->position, alpha);
 }
 
 void DrawEgg(EggSystem* eggSystem, Camera3D camera, Shader shader) {
-    if (!eggSystem->egg.active) return;
+    if (eggSystem->egg == NULL) return;
 
     Vector3 noColor = {0, 0, 0};
     SetShaderValue(shader, GetShaderLocation(shader, "color"), (float*)&noColor, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, GetShaderLocation(shader, "shaderType"), (int[]){eggSystem->egg.colorType}, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "shaderType"), (int[]){eggSystem->egg->colorType}, SHADER_UNIFORM_INT);
 
     Matrix model = MatrixMultiply(
-        MatrixTranslate(eggSystem->egg.position.x, eggSystem->egg.position.y, eggSystem->egg.position.z),
+        MatrixTranslate(eggSystem->egg->renderPosition.x, eggSystem->egg->renderPosition.y, eggSystem->egg->renderPosition.z),
         MatrixScale(MODEL_SCALE, MODEL_SCALE, MODEL_SCALE)
     );
 
@@ -84,7 +136,19 @@ void DrawEgg(EggSystem* eggSystem, Camera3D camera, Shader shader) {
     SetShaderValueMatrix(shader, GetShaderLocation(shader, "mvp"), mvp);
     SetShaderValueMatrix(shader, GetShaderLocation(shader, "normalMatrix"), normalMatrix);
 
-    DrawModel(eggSystem->model, eggSystem->egg.position, 1.0f, WHITE);
+    DrawModel(eggSystem->model, eggSystem->egg->renderPosition, 1.0f, WHITE);
+}
+
+static void DrawEggItem(void* data, Camera3D camera) {
+    EggSystem* eggSystem = (EggSystem*)data;
+    DrawEgg(eggSystem, camera, eggSystem->model.materials[0].shader);
+}
+
+void SubmitEgg(EggSystem* eggSystem, RenderQueue* queue) {
+    if (eggSystem->egg == NULL) return;
+
+    SubmitRenderItem(queue, RENDER_LAYER_OPAQUE, DefaultRenderState(), eggSystem->model.materials[0].shader.id,
+                     eggSystem->egg->renderPosition, DrawEggItem, eggSystem);
 }
 
 void UnloadEggSystem(EggSystem* eggSystem) {
@@ -3,26 +3,40 @@
 
 #include <raylib.h>
 #include "hay.h"
+#include "hay_gpu.h"
+#include "render_queue.h"
 #include "constants.h"
+#include "arena.h"
+
+#define EGG_MASS 0.1f               // kg, against the straw springs of hay.h
+#define EGG_FOOTPRINT_RADIUS 0.1f   // Radius of the straw patch the egg presses on
+#define MAX_PETS 8                  // Capacity of the pets pool
 
 typedef struct {
-    Vector3 position;
+    Vector3 position;           // Bottom of the egg, where it touches the hay
+    Vector3 previousPosition;   // Before the last physics tick
+    Vector3 renderPosition;     // Interpolated between the two, see InterpolateEgg
     Vector3 velocity;
     bool isGrounded;
     int colorType;
-    bool active;
 } PhysicsObject;
 
 typedef struct {
     Model model;
-    PhysicsObject egg;
+    PhysicsObject* egg;         // From the pets pool, NULL until the first SpawnEgg
     int numColors;
 } EggSystem;
 
 EggSystem InitializeEggSystem(Shader shader);
-void SpawnEgg(EggSystem* eggSystem, int colorType);
-void UpdateEggPhysics(EggSystem* eggSystem, HayPiece* hayPieces, float deltaTime);
+// Spawn or respawn the egg, taking its block from pets the first time
+void SpawnEgg(EggSystem* eggSystem, MemPool* pets, int colorType);
+void UpdateEggPhysics(EggSystem* eggSystems, int eggCount, HayPiece* hayPieces, int hayCount, float deltaTime);
+void UpdateEggPhysicsGpu(EggSystem* eggSystem, GpuNest* nest, float deltaTime);
+
+// Place the drawn egg alpha (0..1) of the way from the previous physics tick to the last one
+void InterpolateEgg(EggSystem* eggSystem, float alpha);
 void DrawEgg(EggSystem* eggSystem, Camera3D camera, Shader shader);
+void SubmitEgg(EggSystem* eggSystem, RenderQueue* queue);
 void UnloadEggSystem(EggSystem* eggSystem);
 
 #endif // EGG_H
\ No newline at end of file
@@ -14,90 +14,220 @@ static float QuadraticBezier(float start, float control, float end, float t) {
            2.0f * one_minus_t * t * control + 
            t * t * end;
 }
-void UpdateHayPhysics(HayPiece* hayPieces, CollisionSphere egg, float deltaTime) {
-    const float EGG_WEIGHT = 1.0f;       // Weight of the egg affecting the hay
-    const float DECOMPRESS_RATE = 0.5f; // Rate at which hay decompresses (adjust as needed)
-
-    if (egg.radius <= 0) {
-        // No egg - allow natural decompression without resetting to originalHeight
-        for (int i = 0; i < NUM_HAY_PIECES + TOP_LAYER_PIECES; i++) {
-            // Gradual decompression
-            if (hayPieces[i].compression > 0) {
-                hayPieces[i].compression -= DECOMPRESS_RATE * deltaTime;
-                if (hayPieces[i].compression < 0) {
-                    hayPieces[i].compression = 0; // Ensure compression doesn't go negative
-                }
-
-                // Update Y positions based on remaining compression
-                hayPieces[i].startPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-                hayPieces[i].endPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-                hayPieces[i].controlPoint.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-
-            }
-        }
-        return;
-    }
+// Packed straw encoding, see HayPiece
+#define HAY_POSITION_STEPS 65535.0f
+#define HAY_OFFSET_STEPS 127.0f
+#define HAY_BYTE_STEPS 255.0f
+#define HAY_SPEED_STEPS 127.0f
+
+static float Dequantize(int value, float min, float max, float steps) {
+    return min + (max - min) * ((float)value / steps);
+}
 
-    // Egg is present - update physics for each hay piece
-    for (int i = 0; i < NUM_HAY_PIECES + TOP_LAYER_PIECES; i++) {
-        float dx = hayPieces[i].startPos.x - egg.position.x;
-        float dz = hayPieces[i].startPos.z - egg.position.z;
-        float distance = sqrtf(dx * dx + dz * dz);
+static int Quantize(float value, float min, float max, float steps) {
+    float t = Clamp((value - min) / (max - min), 0.0f, 1.0f);
+    return (int)lroundf(t * steps);
+}
+
+static signed char QuantizeOffset(float offset) {
+    float t = Clamp(offset / HAY_OFFSET_RANGE, -1.0f, 1.0f);
+    return (signed char)lroundf(t * HAY_OFFSET_STEPS);
+}
+
+Vector3 GetHayRestPosition(const HayPiece* hay) {
+    Vector3 min = HAY_BOUNDS_MIN;
+    Vector3 max = HAY_BOUNDS_MAX;
+    return (Vector3){
+        Dequantize(hay->start[0], min.x, max.x, HAY_POSITION_STEPS),
+        Dequantize(hay->start[1], min.y, max.y, HAY_POSITION_STEPS),
+        Dequantize(hay->start[2], min.z, max.z, HAY_POSITION_STEPS)
+    };
+}
+
+static Vector3 GetHayOffset(const signed char offset[3]) {
+    const float scale = HAY_OFFSET_RANGE / HAY_OFFSET_STEPS;
+    return (Vector3){ offset[0] * scale, offset[1] * scale, offset[2] * scale };
+}
 
-        float eggBottom = egg.position.y - egg.radius;
+float GetHayCompression(const HayPiece* hay) {
+    return Dequantize(hay->compression, 0.0f, MAX_COMPRESSION, HAY_POSITION_STEPS);
+}
 
-        // Check if the egg is above the hay piece and within its radius
-        if (eggBottom <= hayPieces[i].originalHeight.y && 
-            egg.position.y > hayPieces[i].originalHeight.y && 
-            distance < egg.radius) {
+static unsigned short PackHayColor(Color color) {
+    return (unsigned short)(((color.r >> 3) << 11) | ((color.g >> 2) << 5) | (color.b >> 3));
+}
 
+static Color GetHayColor(const HayPiece* hay) {
+    // Replicate the high bits into the low ones so 565 white stays 255
+    unsigned char r = (hay->color >> 11) & 0x1F;
+    unsigned char g = (hay->color >> 5) & 0x3F;
+    unsigned char b = hay->color & 0x1F;
+    return (Color){ (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2), 255 };
+}
 
-            // Calculate weight factor based on distance from the egg's center
-            float weight_factor = EGG_WEIGHT * (1.0f - (distance / egg.radius));
-            hayPieces[i].compression += weight_factor * deltaTime;
+Vector3 GetHayStartPosition(const HayPiece* hay) {
+    Vector3 position = GetHayRestPosition(hay);
+    position.y -= GetHayCompression(hay);
+    return position;
+}
 
-            // Clamp compression to a maximum value
-            if (hayPieces[i].compression > MAX_COMPRESSION) {
-                hayPieces[i].compression = MAX_COMPRESSION;
-            }
+static void EncodeHayPiece(HayPiece* hay, Vector3 startPos, Vector3 endPos, Vector3 controlPoint,
+                           float radius, Color color) {
+    Vector3 min = HAY_BOUNDS_MIN;
+    Vector3 max = HAY_BOUNDS_MAX;
+
+    hay->start[0] = (unsigned short)Quantize(startPos.x, min.x, max.x, HAY_POSITION_STEPS);
+    hay->start[1] = (unsigned short)Quantize(startPos.y, min.y, max.y, HAY_POSITION_STEPS);
+    hay->start[2] = (unsigned short)Quantize(startPos.z, min.z, max.z, HAY_POSITION_STEPS);
+
+    // Offsets are taken from the quantized start so the error doesn't add up
+    Vector3 rest = GetHayRestPosition(hay);
+    hay->end[0] = QuantizeOffset(endPos.x - rest.x);
+    hay->end[1] = QuantizeOffset(endPos.y - rest.y);
+    hay->end[2] = QuantizeOffset(endPos.z - rest.z);
+    hay->control[0] = QuantizeOffset(controlPoint.x - rest.x);
+    hay->control[1] = QuantizeOffset(controlPoint.y - rest.y);
+    hay->control[2] = QuantizeOffset(controlPoint.z - rest.z);
+
+    hay->compression = 0;
+    hay->velocity = 0;
+    hay->radius = (unsigned char)Quantize(radius, 0.0f, HAY_MAX_RADIUS, HAY_BYTE_STEPS);
+    hay->color = PackHayColor(color);
+}
 
-            // Update Y positions based on current compression
-            hayPieces[i].startPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-            hayPieces[i].endPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-            hayPieces[i].controlPoint.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
+// Weight of a straw under an egg footprint, 1 at the center fading to 0 at the rim
+static float GetContactWeight(Vector3 rest, CollisionSphere egg) {
+    float dx = rest.x - egg.position.x;
+    float dz = rest.z - egg.position.z;
+    float distance = sqrtf(dx * dx + dz * dz);
+    return (distance < egg.radius) ? 1.0f - distance / egg.radius : 0.0f;
+}
+
+// Compression of a straw whose top is held at the egg bottom
+static float GetHayContactTarget(float restHeight, float weight, float eggHeight) {
+    return Clamp(weight * (restHeight - eggHeight), 0.0f, MAX_COMPRESSION);
+}
 
+// Time for a free fall from height y at velocity v to come down to height h
+static float GetFallTime(float y, float v, float h) {
+    float drop = y - h;
+    if (drop <= 0.0f) return 0.0f;
+
+    // Two forms of the same root, each free of cancellation for its sign of v
+    float root = sqrtf(v * v + 2.0f * GRAVITY * drop);
+    return (v <= 0.0f) ? 2.0f * drop / (root - v) : (v + root) / GRAVITY;
+}
+
+void AddHayContact(HayContact* contact, const HayEgg* egg, float weight, float restHeight,
+                   float compression, float velocity, float straws, float deltaTime) {
+    // The egg bottom touches the straw once it is down to the straw's top
+    float top = restHeight - compression / weight;
+    float impact = GetFallTime(egg->footprint.position.y, egg->velocity, top);
+    if (impact >= deltaTime) return;
+
+    if (contact->straws == 0 || impact < contact->impactTime) contact->impactTime = impact;
+
+    // Weighted by the time left in the step, FinishHayContact divides by the
+    // time left after the first impact
+    float share = straws * (deltaTime - impact);
+    contact->force += share * weight * HAY_STIFFNESS * compression;
+    contact->momentum += share * weight * HAY_STRAW_MASS * velocity;
+    contact->stiffness += share * weight * weight * HAY_STIFFNESS;
+    contact->damping += share * weight * weight * HAY_DAMPING;
+    contact->mass += share * weight * weight * HAY_STRAW_MASS;
+    contact->straws += (int)straws;
+}
+
+void FinishHayContact(HayContact* contact, float deltaTime) {
+    if (contact->straws == 0) {
+        *contact = (HayContact){ .impactTime = deltaTime };
+        return;
+    }
+
+    float remaining = deltaTime - contact->impactTime;
+    contact->force /= remaining;
+    contact->momentum /= remaining;
+    contact->stiffness /= remaining;
+    contact->damping /= remaining;
+    contact->mass /= remaining;
+}
+
+void UpdateHayPhysics(HayPiece* hayPieces, int count, HayEgg* eggs, int eggCount, float deltaTime) {
+    const float compressionStep = MAX_COMPRESSION / HAY_POSITION_STEPS;
+    const float speedStep = HAY_MAX_SPEED / HAY_SPEED_STEPS;
+
+    // Backward Euler on m*c'' = -k*c - d*c', solved for the new velocity so
+    // any step size stays stable
+    const float dt = deltaTime;
+    const float denominator = 1.0f + dt * HAY_DAMPING / HAY_STRAW_MASS +
+                              dt * dt * HAY_STIFFNESS / HAY_STRAW_MASS;
+
+    for (int e = 0; e < eggCount; e++) eggs[e].contact = (HayContact){0};
+
+    for (int i = 0; i < count; i++) {
+        HayPiece* hay = &hayPieces[i];
+
+        // The lowest egg bottom over the straw holds it down the furthest
+        Vector3 rest = { 0 };
+        float target = 0.0f;
+        bool underEgg = false;
+        if (eggCount > 0) rest = GetHayRestPosition(hay);
+        for (int e = 0; e < eggCount; e++) {
+            float weight = GetContactWeight(rest, eggs[e].footprint);
+            if (weight <= 0.0f) continue;
+            target = fmaxf(target, GetHayContactTarget(rest.y, weight, eggs[e].footprint.position.y));
+            underEgg = true;
+        }
+
+        if (hay->compression == 0 && hay->velocity == 0 && !underEgg) continue;
+
+        float compression = hay->compression * compressionStep;
+        float velocity = hay->velocity * speedStep;
+
+        // The straw springs back on its own unless an egg bottom holds it down
+        float freeVelocity = (velocity - dt * HAY_STIFFNESS * compression / HAY_STRAW_MASS) / denominator;
+        if (compression + dt * freeVelocity < target) {
+            velocity = (target - compression) / dt;
+            compression = target;
         } else {
-            // Gradual decompression when the egg is not affecting this piece
-            if (hayPieces[i].compression > 0) {
-                hayPieces[i].compression -= DECOMPRESS_RATE * deltaTime;
-                if (hayPieces[i].compression < 0) {
-                    hayPieces[i].compression = 0; // Ensure compression doesn't go negative
-                }
-
-                // Update Y positions based on remaining compression
-                hayPieces[i].startPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-                hayPieces[i].endPos.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-                hayPieces[i].controlPoint.y = hayPieces[i].originalHeight.y - hayPieces[i].compression;
-
-            }
+            velocity = freeVelocity;
+            compression += dt * freeVelocity;
         }
+
+        // A fully compressed or relaxed straw stops at the limit
+        if (compression <= 0.0f || compression >= MAX_COMPRESSION) velocity = 0.0f;
+        compression = Clamp(compression, 0.0f, MAX_COMPRESSION);
+
+        // Straws whose top an egg reaches push back on it with their new state
+        for (int e = 0; underEgg && e < eggCount; e++) {
+            float weight = GetContactWeight(rest, eggs[e].footprint);
+            if (weight <= 0.0f) continue;
+            AddHayContact(&eggs[e].contact, &eggs[e], weight, rest.y, compression, velocity, 1.0f, dt);
+        }
+
+        // 16-bit steps are a few micrometres, so rounding only parks a straw
+        // once it is practically at its target
+        hay->compression = (unsigned short)Quantize(compression, 0.0f, MAX_COMPRESSION, HAY_POSITION_STEPS);
+        hay->velocity = (signed char)lroundf(Clamp(velocity / speedStep, -HAY_SPEED_STEPS, HAY_SPEED_STEPS));
     }
-}
 
+    for (int e = 0; e < eggCount; e++) FinishHayContact(&eggs[e].contact, dt);
+}
 
-float CalculateHayHeight(Vector3 position, HayPiece* hayPieces) {
+float CalculateHayHeight(Vector3 position, HayPiece* hayPieces, int count) {
     float maxHeight = GROUND_Y;
     float weightedSum = 0;
     float totalWeight = 0;
 
-    for (int i = 0; i < NUM_HAY_PIECES + TOP_LAYER_PIECES; i++) {
-        float dx = hayPieces[i].startPos.x - position.x;
-        float dz = hayPieces[i].startPos.z - position.z;
+    for (int i = 0; i < count; i++) {
+        Vector3 startPos = GetHayStartPosition(&hayPieces[i]);
+        float dx = startPos.x - position.x;
+        float dz = startPos.z - position.z;
         float distance = sqrtf(dx * dx + dz * dz);
 
         if (distance < NEST_RADIUS) {
             float weight = 1.0f / (1.0f + distance);
-            weightedSum += (hayPieces[i].startPos.y - hayPieces[i].compression) * weight;
+            weightedSum += (startPos.y - GetHayCompression(&hayPieces[i])) * weight;
             totalWeight += weight;
         }
     }
@@ -109,11 +239,15 @@ float CalculateHayHeight(Vector3 position, HayPiece* hayPieces) {
     return maxHeight;
 }
 
-HayPiece* InitializeNest(void) {
-    HayPiece* hayPieces = (HayPiece*)malloc((NUM_HAY_PIECES + TOP_LAYER_PIECES) * sizeof(HayPiece));
+HayPiece* InitializeNest(MemArena* arena, int count) {
+    HayPiece* hayPieces = (HayPiece*)ArenaAlloc(arena, (size_t)count * sizeof(HayPiece));
+    if (hayPieces == NULL) return NULL;
+
+    int topPieces = (int)((long long)count * TOP_LAYER_PIECES / NUM_NEST_PIECES);
+    int basePieces = count - topPieces;
 
     // Base layer
-    for (int i = 0; i < NUM_HAY_PIECES; i++) {
+    for (int i = 0; i < basePieces; i++) {
         float angle = GetRandomFloat(0, 2 * PI);
         float radius = GetRandomFloat(NEST_RADIUS * 0.3f, NEST_RADIUS);
         float height = GetRandomFloat(0, NEST_HEIGHT * 0.7f);
@@ -129,32 +263,30 @@ HayPiece* InitializeNest(void) {
 
         float centerAngle = atan2f(basePos.x, basePos.z);
 
-        hayPieces[i].startPos = basePos;
-        hayPieces[i].originalHeight = basePos;
-        hayPieces[i].compression = 0;
-        hayPieces[i].endPos = (Vector3){
+        Vector3 endPos = (Vector3){
             basePos.x - sinf(centerAngle) * pieceLength * 0.5f,
             basePos.y + GetRandomFloat(-0.05f, 0.05f),
             basePos.z - cosf(centerAngle) * pieceLength * 0.5f
         };
-        hayPieces[i].controlPoint = (Vector3){
-            (basePos.x + hayPieces[i].endPos.x) / 2 + curvature,
+        Vector3 controlPoint = (Vector3){
+            (basePos.x + endPos.x) / 2 + curvature,
             basePos.y + GetRandomFloat(0.05f, 0.15f),
-            (basePos.z + hayPieces[i].endPos.z) / 2 + curvature
+            (basePos.z + endPos.z) / 2 + curvature
         };
-        hayPieces[i].radius = GetRandomFloat(0.002f, 0.004f);
-        hayPieces[i].color = (Color){
+        float pieceRadius = GetRandomFloat(0.002f, 0.004f);
+        Color color = (Color){
             GetRandomValue(220, 255),
             GetRandomValue(180, 223),
             GetRandomValue(60, 91),
             255
         };
+        EncodeHayPiece(&hayPieces[i], basePos, endPos, controlPoint, pieceRadius, color);
 
     }
 
     // Top layer
-    for (int i = 0; i < TOP_LAYER_PIECES; i++) {
-        int idx = NUM_HAY_PIECES + i;
+    for (int i = 0; i < topPieces; i++) {
+        int idx = basePieces + i;
         float angle = GetRandomFloat(0, 2 * PI);
         float radius = GetRandomFloat(0, NEST_RADIUS * 0.6f);
         float height = NEST_HEIGHT * 0.6f + GetRandomFloat(0, NEST_HEIGHT * 0.4f);
@@ -168,51 +300,60 @@ HayPiece* InitializeNest(void) {
         float centerAngle = atan2f(basePos.x, basePos.z);
         float pieceLength = GetRandomFloat(0.1f, 0.3f);
 
-        hayPieces[idx].startPos = basePos;
-        hayPieces[idx].originalHeight = basePos;
-        hayPieces[idx].compression = 0;
-        hayPieces[idx].endPos = (Vector3){
+        Vector3 endPos = (Vector3){
             basePos.x - sinf(centerAngle) * pieceLength * 0.5f,
             basePos.y + GetRandomFloat(-0.05f, 0.05f),
             basePos.z - cosf(centerAngle) * pieceLength * 0.5f
         };
-        hayPieces[idx].controlPoint = (Vector3){
-            (basePos.x + hayPieces[idx].endPos.x) / 2,
+        Vector3 controlPoint = (Vector3){
+            (basePos.x + endPos.x) / 2,
             basePos.y + GetRandomFloat(0.05f, 0.15f),
-            (basePos.z + hayPieces[idx].endPos.z) / 2
+            (basePos.z + endPos.z) / 2
         };
-        hayPieces[idx].radius = GetRandomFloat(0.002f, 0.004f);
-        hayPieces[idx].color = (Color){
+        float pieceRadius = GetRandomFloat(0.002f, 0.004f);
+        Color color = (Color){
             GetRandomValue(220, 255),
             GetRandomValue(180, 223),
             GetRandomValue(60, 91),
             255
         };
+        EncodeHayPiece(&hayPieces[idx], basePos, endPos, controlPoint, pieceRadius, color);
 
     }
 
     return hayPieces;
 }
 
-void DrawHayPiece(HayPiece hay) {
+void DrawHayPiece(HayPiece hay, float renderAhead) {
     const int segments = 8;
 
+    // The straws are stepped against where the egg was before its last tick,
+    // so they are carried forward along their velocity to meet the drawn egg
+    float velocity = hay.velocity * HAY_MAX_SPEED / HAY_SPEED_STEPS;
+    float compression = Clamp(GetHayCompression(&hay) + renderAhead * velocity, 0.0f, MAX_COMPRESSION);
+    Vector3 startPos = GetHayRestPosition(&hay);
+    startPos.y -= compression;
+    Vector3 endPos = Vector3Add(startPos, GetHayOffset(hay.end));
+    Vector3 controlPoint = Vector3Add(startPos, GetHayOffset(hay.control));
+    float radius = Dequantize(hay.radius, 0.0f, HAY_MAX_RADIUS, HAY_BYTE_STEPS);
+    Color color = GetHayColor(&hay);
+
     for (int i = 0; i < segments - 1; i++) {
         float t1 = (float)i / (segments - 1);
         float t2 = (float)(i + 1) / (segments - 1);
 
         Vector3 p1 = {
-            QuadraticBezier(hay.startPos.x, hay.controlPoint.x, hay.endPos.x, t1),
-            QuadraticBezier(hay.startPos.y, hay.controlPoint.y, hay.endPos.y, t1),
-            QuadraticBezier(hay.startPos.z, hay.controlPoint.z, hay.endPos.z, t1)
+            QuadraticBezier(startPos.x, controlPoint.x, endPos.x, t1),
+            QuadraticBezier(startPos.y, controlPoint.y, endPos.y, t1),
+            QuadraticBezier(startPos.z, controlPoint.z, endPos.z, t1)
         };
 
         Vector3 p2 = {
-            QuadraticBezier(hay.startPos.x, hay.controlPoint.x, hay.endPos.x, t2),
-            QuadraticBezier(hay.startPos.y, hay.controlPoint.y, hay.endPos.y, t2),
-            QuadraticBezier(hay.startPos.z, hay.controlPoint.z, hay.endPos.z, t2)
+            QuadraticBezier(startPos.x, controlPoint.x, endPos.x, t2),
+            QuadraticBezier(startPos.y, controlPoint.y, endPos.y, t2),
+            QuadraticBezier(startPos.z, controlPoint.z, endPos.z, t2)
         };
 
-        DrawCylinderEx(p1, p2, hay.radius, hay.radius, 4, hay.color);
+        DrawCylinderEx(p1, p2, radius, radius, 4, color);
     }
-}
\ No newline at end of file
+}
@@ -4,23 +4,37 @@
 #include <raylib.h>
 #include <raymath.h>
 #include "constants.h"
+#include "arena.h"
 
 #define NUM_HAY_PIECES 1000
 #define NEST_RADIUS 0.4f
 #define NEST_HEIGHT 0.2f
 #define TOP_LAYER_PIECES 300
-#define HAY_STIFFNESS 5.0f     
-#define HAY_DAMPING 0.5f        
+#define NUM_NEST_PIECES (NUM_HAY_PIECES + TOP_LAYER_PIECES)
+#define HAY_STIFFNESS 5.0f      // Spring constant of one straw, N/m
+#define HAY_DAMPING 0.5f        // Damping of one straw, N*s/m
+#define HAY_STRAW_MASS 0.05f    // Mass a straw moves as it springs back, kg
+#define HAY_MAX_SPEED 2.0f      // Range of the quantized compression velocity, m/s
 #define MAX_COMPRESSION 0.15f   
 
+// Quantization ranges of the packed straw. Rest positions lie inside the nest
+// bounds; the other two curve points are stored as small offsets from them.
+#define HAY_BOUNDS_MIN ((Vector3){ -NEST_RADIUS, 0.0f, -NEST_RADIUS })
+#define HAY_BOUNDS_MAX ((Vector3){ NEST_RADIUS, NEST_HEIGHT, NEST_RADIUS })
+#define HAY_OFFSET_RANGE 0.32f
+#define HAY_MAX_RADIUS 0.005f
+
+// 18 bytes per straw. Compression lowers all three curve points together and
+// keeps the straw's shape, so the rest height of the start point is shared by
+// the whole straw.
 typedef struct {
-    Vector3 startPos;
-    Vector3 endPos;
-    Vector3 controlPoint;
-    Vector3 originalHeight;  
-    float compression;         
-    float radius;
-    Color color;
+    unsigned short start[3];    // Rest position, 16-bit fixed point within the nest bounds
+    unsigned short compression; // 0..65535 maps to 0..MAX_COMPRESSION
+    signed char end[3];         // Offsets from start, in units of HAY_OFFSET_RANGE / 127
+    signed char control[3];
+    signed char velocity;       // Compression rate, in units of HAY_MAX_SPEED / 127
+    unsigned char radius;       // 0..255 maps to 0..HAY_MAX_RADIUS
+    unsigned short color;       // RGB565, straws are always opaque
 } HayPiece;
 
 typedef struct {
@@ -29,10 +43,49 @@ typedef struct {
     bool active;
 } CollisionSphere;
 
-HayPiece* InitializeNest(void);
-void DrawHayPiece(HayPiece hay);
+// Straws an egg presses on during a step, from their compression c and its
+// rate c', summed with their contact weights w: F = sum(w*k*c), P = sum(w*m*c'),
+// K = sum(w^2*k), C = sum(w^2*d), M = sum(w^2*m). The egg falls freely until
+// impactTime; each straw counts for the share of the rest of the step it is
+// actually touched.
+typedef struct {
+    float impactTime;   // Into the step, when the egg reaches its first straw, s
+    float force;        // Upward spring force on the egg, N
+    float momentum;     // Of the straws moving with the egg, downward, kg*m/s
+    float stiffness;
+    float damping;
+    float mass;
+    int straws;
+} HayContact;
+
+// An egg on the nest for one step
+typedef struct {
+    CollisionSphere footprint;  // Egg bottom at the start of the step
+    float velocity;             // Vertical, m/s
+    HayContact contact;         // Filled in by UpdateHayPhysics
+} HayEgg;
+
+#define NEST_ARENA_SIZE (NUM_NEST_PIECES * sizeof(HayPiece))
+
+// Build a nest of count straws, split between base and top layer like the default nest
+HayPiece* InitializeNest(MemArena* arena, int count);
+// Draw with the compression renderAhead seconds past the last step
+void DrawHayPiece(HayPiece hay, float renderAhead);
 float GetRandomFloat(float min, float max);
-void UpdateHayPhysics(HayPiece* hayPieces, CollisionSphere egg, float deltaTime);
-float CalculateHayHeight(Vector3 position, HayPiece* hayPieces);
+// Step every straw's spring once, held down by the lowest egg bottom over it,
+// and in the same pass sum the contact of each egg. Stable for any deltaTime.
+void UpdateHayPhysics(HayPiece* hayPieces, int count, HayEgg* eggs, int eggCount, float deltaTime);
+
+// Add straws sharing one state to an egg's contact if the egg reaches their
+// top within the step, then turn the sums into the contact once all are added.
+// UpdateHayPhysics does both; nests kept elsewhere use them directly.
+void AddHayContact(HayContact* contact, const HayEgg* egg, float weight, float restHeight,
+                   float compression, float velocity, float straws, float deltaTime);
+void FinishHayContact(HayContact* contact, float deltaTime);
+
+float CalculateHayHeight(Vector3 position, HayPiece* hayPieces, int count);
+float GetHayCompression(const HayPiece* hay);
+Vector3 GetHayStartPosition(const HayPiece* hay);   // Current, compressed position
+Vector3 GetHayRestPosition(const HayPiece* hay);
 
 #endif
\ No newline at end of file
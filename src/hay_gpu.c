@@ -0,0 +1,421 @@
+#include "hay_gpu.h"
+#if defined(HAY_GPU_GLAD)
+    #include "glad.h"       // raylib's GL loader, its entry points are loaded by InitWindow
+#else
+    #define GL_GLEXT_PROTOTYPES     // No glad.h with packaged raylib, link GL 3.3 from libGL
+    #include <GL/gl.h>
+    #include <GL/glext.h>
+#endif
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+#include <rlgl.h>
+#include "arena.h"
+
+// Vertex attribute locations, fixed in the hay_*.vs shaders
+#define HAY_ATTRIB_REST 0
+#define HAY_ATTRIB_END 1
+#define HAY_ATTRIB_CONTROL 2
+#define HAY_ATTRIB_COLOR 3
+#define HAY_ATTRIB_STATE 4
+#define HAY_ATTRIB_RADIUS 5
+
+#define FIELD_CELLS (GPU_NEST_FIELD_SIZE * GPU_NEST_FIELD_SIZE)
+
+// GL state touched by the nest passes. rlgl caches some of it, so it has to
+// look exactly the same afterwards.
+typedef struct {
+    GLint program;
+    GLint vertexArray;
+    GLint arrayBuffer;
+    GLint packBuffer;
+    GLint drawFramebuffer;
+    GLint readFramebuffer;
+    GLint viewport[4];
+    GLboolean blend;
+    GLboolean depthTest;
+    GLint blendSrcRgb, blendDstRgb, blendSrcAlpha, blendDstAlpha;
+    GLint blendEquationRgb, blendEquationAlpha;
+} GLStateSnapshot;
+
+static GLStateSnapshot SaveGLState(void) {
+    // Anything raylib has batched must reach GL before we change state under it
+    rlDrawRenderBatchActive();
+
+    GLStateSnapshot state;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &state.program);
+    glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &state.vertexArray);
+    glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &state.arrayBuffer);
+    glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &state.packBuffer);
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &state.drawFramebuffer);
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &state.readFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, state.viewport);
+    state.blend = glIsEnabled(GL_BLEND);
+    state.depthTest = glIsEnabled(GL_DEPTH_TEST);
+    glGetIntegerv(GL_BLEND_SRC_RGB, &state.blendSrcRgb);
+    glGetIntegerv(GL_BLEND_DST_RGB, &state.blendDstRgb);
+    glGetIntegerv(GL_BLEND_SRC_ALPHA, &state.blendSrcAlpha);
+    glGetIntegerv(GL_BLEND_DST_ALPHA, &state.blendDstAlpha);
+    glGetIntegerv(GL_BLEND_EQUATION_RGB, &state.blendEquationRgb);
+    glGetIntegerv(GL_BLEND_EQUATION_ALPHA, &state.blendEquationAlpha);
+    return state;
+}
+
+static void RestoreGLState(const GLStateSnapshot* state) {
+    glUseProgram(state->program);
+    glBindVertexArray(state->vertexArray);
+    glBindBuffer(GL_ARRAY_BUFFER, state->arrayBuffer);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, state->packBuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, state->drawFramebuffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, state->readFramebuffer);
+    glViewport(state->viewport[0], state->viewport[1], state->viewport[2], state->viewport[3]);
+    if (state->blend) glEnable(GL_BLEND); else glDisable(GL_BLEND);
+    if (state->depthTest) glEnable(GL_DEPTH_TEST); else glDisable(GL_DEPTH_TEST);
+    glBlendFuncSeparate(state->blendSrcRgb, state->blendDstRgb, state->blendSrcAlpha, state->blendDstAlpha);
+    glBlendEquationSeparate(state->blendEquationRgb, state->blendEquationAlpha);
+}
+
+static GLuint CompileHayShader(GLenum type, const char* fileName) {
+    char* source = LoadFileText(fileName);
+    if (source == NULL) return 0;
+
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, (const GLchar* const*)&source, NULL);
+    glCompileShader(shader);
+    UnloadFileText(source);
+
+    GLint success = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if (success != GL_TRUE) {
+        char log[512];
+        glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+        TraceLog(LOG_WARNING, "HAY_GPU: [%s] Failed to compile: %s", fileName, log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Link a program. With a feedback varying and no fragment shader the program
+// only runs for its transform feedback output.
+static GLuint LoadHayProgram(const char* vsFileName, const char* fsFileName, const char* feedbackVarying) {
+    GLuint vertexShader = CompileHayShader(GL_VERTEX_SHADER, vsFileName);
+    GLuint fragmentShader = (fsFileName != NULL) ? CompileHayShader(GL_FRAGMENT_SHADER, fsFileName) : 0;
+    if (vertexShader == 0 || (fsFileName != NULL && fragmentShader == 0)) {
+        if (vertexShader != 0) glDeleteShader(vertexShader);
+        if (fragmentShader != 0) glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    if (fragmentShader != 0) glAttachShader(program, fragmentShader);
+    if (feedbackVarying != NULL) {
+        glTransformFeedbackVaryings(program, 1, &feedbackVarying, GL_INTERLEAVED_ATTRIBS);
+    }
+    glLinkProgram(program);
+    glDeleteShader(vertexShader);
+    if (fragmentShader != 0) glDeleteShader(fragmentShader);
+
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (success != GL_TRUE) {
+        char log[512];
+        glGetProgramInfoLog(program, sizeof(log), NULL, log);
+        TraceLog(LOG_WARNING, "HAY_GPU: [%s] Failed to link: %s", vsFileName, log);
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Per-straw attributes: the packed HayPiece fields plus the float spring state.
+// Signed offsets stay unnormalized, GL 3.3 and 4.2+ normalize signed bytes differently.
+// The RGB565 color is an integer attribute, unpacked in the shader.
+static GLuint CreateStrawVertexArray(GLuint restBuffer, GLuint stateBuffer, GLuint divisor) {
+    GLuint vao;
+    glGenVertexArrays(1, &vao);
+    glBindVertexArray(vao);
+
+    glBindBuffer(GL_ARRAY_BUFFER, restBuffer);
+    glVertexAttribPointer(HAY_ATTRIB_REST, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(HayPiece),
+                          (void*)offsetof(HayPiece, start));
+    glVertexAttribPointer(HAY_ATTRIB_END, 3, GL_BYTE, GL_FALSE, sizeof(HayPiece),
+                          (void*)offsetof(HayPiece, end));
+    glVertexAttribPointer(HAY_ATTRIB_CONTROL, 3, GL_BYTE, GL_FALSE, sizeof(HayPiece),
+                          (void*)offsetof(HayPiece, control));
+    glVertexAttribIPointer(HAY_ATTRIB_COLOR, 1, GL_UNSIGNED_SHORT, sizeof(HayPiece),
+                           (void*)offsetof(HayPiece, color));
+    glVertexAttribPointer(HAY_ATTRIB_RADIUS, 1, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HayPiece),
+                          (void*)offsetof(HayPiece, radius));
+
+    glBindBuffer(GL_ARRAY_BUFFER, stateBuffer);
+    glVertexAttribPointer(HAY_ATTRIB_STATE, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    for (GLuint i = HAY_ATTRIB_REST; i <= HAY_ATTRIB_RADIUS; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, divisor);
+    }
+    return vao;
+}
+
+static void SetNestBounds(GLuint program) {
+    Vector3 min = HAY_BOUNDS_MIN;
+    Vector3 max = HAY_BOUNDS_MAX;
+    glUseProgram(program);
+    glUniform3f(glGetUniformLocation(program, "boundsMin"), min.x, min.y, min.z);
+    glUniform3f(glGetUniformLocation(program, "boundsMax"), max.x, max.y, max.z);
+}
+
+static int GetFieldCell(float x, float z) {
+    Vector3 min = HAY_BOUNDS_MIN;
+    Vector3 max = HAY_BOUNDS_MAX;
+    int cellX = (int)((x - min.x) / (max.x - min.x) * GPU_NEST_FIELD_SIZE);
+    int cellZ = (int)((z - min.z) / (max.z - min.z) * GPU_NEST_FIELD_SIZE);
+    cellX = (int)Clamp((float)cellX, 0.0f, GPU_NEST_FIELD_SIZE - 1);
+    cellZ = (int)Clamp((float)cellZ, 0.0f, GPU_NEST_FIELD_SIZE - 1);
+    return cellZ * GPU_NEST_FIELD_SIZE + cellX;
+}
+
+GpuNest CreateGpuNest(const HayPiece* hayPieces, int count) {
+    GpuNest nest = {0};
+    nest.count = count;
+
+    GLStateSnapshot state = SaveGLState();
+
+    nest.simulateProgram = LoadHayProgram("shaders/hay_simulate.vs", NULL, "outState");
+    nest.drawProgram = LoadHayProgram("shaders/hay_draw.vs", "shaders/hay_draw.fs", NULL);
+    nest.fieldProgram = LoadHayProgram("shaders/hay_field.vs", "shaders/hay_field.fs", NULL);
+    if (nest.simulateProgram == 0 || nest.drawProgram == 0 || nest.fieldProgram == 0) {
+        RestoreGLState(&state);
+        UnloadGpuNest(&nest);
+        return nest;
+    }
+
+    // Constant uniforms are set once, programs keep them
+    SetNestBounds(nest.simulateProgram);
+    glUniform1f(glGetUniformLocation(nest.simulateProgram, "maxCompression"), MAX_COMPRESSION);
+    glUniform1f(glGetUniformLocation(nest.simulateProgram, "stiffness"), HAY_STIFFNESS);
+    glUniform1f(glGetUniformLocation(nest.simulateProgram, "damping"), HAY_DAMPING);
+    glUniform1f(glGetUniformLocation(nest.simulateProgram, "strawMass"), HAY_STRAW_MASS);
+    nest.eggsLoc = glGetUniformLocation(nest.simulateProgram, "eggs");
+    nest.eggCountLoc = glGetUniformLocation(nest.simulateProgram, "eggCount");
+    nest.deltaTimeLoc = glGetUniformLocation(nest.simulateProgram, "deltaTime");
+
+    SetNestBounds(nest.drawProgram);
+    glUniform1f(glGetUniformLocation(nest.drawProgram, "offsetScale"), HAY_OFFSET_RANGE / 127.0f);
+    glUniform1f(glGetUniformLocation(nest.drawProgram, "maxRadius"), HAY_MAX_RADIUS);
+    glUniform1i(glGetUniformLocation(nest.drawProgram, "segments"), GPU_NEST_SEGMENTS);
+    nest.mvpLoc = glGetUniformLocation(nest.drawProgram, "mvp");
+    nest.cameraPositionLoc = glGetUniformLocation(nest.drawProgram, "cameraPosition");
+    nest.renderAheadLoc = glGetUniformLocation(nest.drawProgram, "renderAhead");
+    glUniform1f(glGetUniformLocation(nest.drawProgram, "maxCompression"), MAX_COMPRESSION);
+
+    glUseProgram(nest.fieldProgram);
+    glUniform1f(glGetUniformLocation(nest.fieldProgram, "fieldSize"), (float)GPU_NEST_FIELD_SIZE);
+
+    // Straw data, with the spring state unpacked to floats for the simulation
+    glGenBuffers(1, &nest.restBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, nest.restBuffer);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)count * sizeof(HayPiece), hayPieces, GL_STATIC_DRAW);
+
+    float* springState = (float*)MemAlloc(count * 2 * sizeof(float));
+    for (int i = 0; i < count; i++) {
+        springState[i * 2] = GetHayCompression(&hayPieces[i]);
+        springState[i * 2 + 1] = hayPieces[i].velocity * HAY_MAX_SPEED / 127.0f;
+    }
+    glGenBuffers(2, nest.stateBuffers);
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_ARRAY_BUFFER, nest.stateBuffers[i]);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)count * 2 * sizeof(float), springState, GL_DYNAMIC_COPY);
+        nest.pointVao[i] = CreateStrawVertexArray(nest.restBuffer, nest.stateBuffers[i], 0);
+        nest.instanceVao[i] = CreateStrawVertexArray(nest.restBuffer, nest.stateBuffers[i], 1);
+    }
+    MemFree(springState);
+
+    // Spring grid target and its readback buffers
+    glGenTextures(1, &nest.fieldTexture);
+    glBindTexture(GL_TEXTURE_2D, nest.fieldTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, GPU_NEST_FIELD_SIZE, GPU_NEST_FIELD_SIZE, 0, GL_RG, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &nest.fieldFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, nest.fieldFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, nest.fieldTexture, 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        TraceLog(LOG_WARNING, "HAY_GPU: Spring grid framebuffer [ID %i] is not complete", nest.fieldFramebuffer);
+    }
+
+    glGenBuffers(2, nest.readbackBuffers);
+    for (int i = 0; i < 2; i++) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, nest.readbackBuffers[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, sizeof(nest.springField), NULL, GL_STREAM_READ);
+    }
+
+    RestoreGLState(&state);
+
+    // Rest heights never change, so their grid is built once here. The spring
+    // grid starts from the uploaded state until the first readback lands.
+    for (int i = 0; i < count; i++) {
+        Vector3 rest = GetHayRestPosition(&hayPieces[i]);
+        int cell = GetFieldCell(rest.x, rest.z);
+        nest.restField[cell * 2] += rest.y;
+        nest.restField[cell * 2 + 1] += 1.0f;
+        nest.springField[cell * 2] += GetHayCompression(&hayPieces[i]);
+        nest.springField[cell * 2 + 1] += hayPieces[i].velocity * HAY_MAX_SPEED / 127.0f;
+    }
+
+    TrackGpuMemory(MEMORY_NEST, (size_t)count * (sizeof(HayPiece) + 4 * sizeof(float)));
+    TrackGpuMemory(MEMORY_NEST, 3 * sizeof(nest.springField));
+
+    nest.ready = true;
+    return nest;
+}
+
+// Copy finished readbacks into the CPU spring grid, oldest first, without waiting
+static void PollGpuNestReadback(GpuNest* nest) {
+    for (int n = 0; n < 2; n++) {
+        int slot = (nest->readbackSlot + n) % 2;
+        GLsync fence = (GLsync)nest->readbackFences[slot];
+        if (fence == NULL) continue;
+
+        GLenum status = glClientWaitSync(fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) continue;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, nest->readbackBuffers[slot]);
+        void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, sizeof(nest->springField), GL_MAP_READ_BIT);
+        if (pixels != NULL) {
+            memcpy(nest->springField, pixels, sizeof(nest->springField));
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glDeleteSync(fence);
+        nest->readbackFences[slot] = NULL;
+    }
+}
+
+void UpdateGpuNest(GpuNest* nest, const CollisionSphere* eggs, int eggCount, float deltaTime) {
+    if (!nest->ready) return;
+
+    GLStateSnapshot state = SaveGLState();
+    PollGpuNestReadback(nest);
+
+    float eggData[GPU_NEST_MAX_EGGS * 4] = {0};
+    if (eggCount > GPU_NEST_MAX_EGGS) eggCount = GPU_NEST_MAX_EGGS;
+    for (int i = 0; i < eggCount; i++) {
+        eggData[i * 4] = eggs[i].position.x;
+        eggData[i * 4 + 1] = eggs[i].position.y;
+        eggData[i * 4 + 2] = eggs[i].position.z;
+        eggData[i * 4 + 3] = eggs[i].radius;
+    }
+
+    // Spring step: current buffer in, the other one out
+    int next = 1 - nest->current;
+    glUseProgram(nest->simulateProgram);
+    glUniform4fv(nest->eggsLoc, GPU_NEST_MAX_EGGS, eggData);
+    glUniform1i(nest->eggCountLoc, eggCount);
+    glUniform1f(nest->deltaTimeLoc, deltaTime);
+
+    glBindVertexArray(nest->pointVao[nest->current]);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, nest->stateBuffers[next]);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, nest->count);
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+    nest->current = next;
+
+    // Sum the new spring state per grid cell
+    glBindFramebuffer(GL_FRAMEBUFFER, nest->fieldFramebuffer);
+    glViewport(0, 0, GPU_NEST_FIELD_SIZE, GPU_NEST_FIELD_SIZE);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFuncSeparate(GL_ONE, GL_ONE, GL_ONE, GL_ONE);
+    glBlendEquationSeparate(GL_FUNC_ADD, GL_FUNC_ADD);
+
+    glUseProgram(nest->fieldProgram);
+    glBindVertexArray(nest->pointVao[nest->current]);
+    glDrawArrays(GL_POINTS, 0, nest->count);
+
+    // Queue the readback unless that buffer is still in flight
+    int slot = nest->readbackSlot;
+    if (nest->readbackFences[slot] == NULL) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, nest->readbackBuffers[slot]);
+        glReadPixels(0, 0, GPU_NEST_FIELD_SIZE, GPU_NEST_FIELD_SIZE, GL_RG, GL_FLOAT, (void*)0);
+        nest->readbackFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        nest->readbackSlot = 1 - slot;
+    }
+
+    RestoreGLState(&state);
+}
+
+HayContact GatherGpuNestContact(const GpuNest* nest, const HayEgg* egg, float deltaTime) {
+    CollisionSphere footprint = egg->footprint;
+    Vector3 min = HAY_BOUNDS_MIN;
+    Vector3 max = HAY_BOUNDS_MAX;
+    float cellWidth = (max.x - min.x) / GPU_NEST_FIELD_SIZE;
+    float cellDepth = (max.z - min.z) / GPU_NEST_FIELD_SIZE;
+    HayContact contact = {0};
+
+    for (int i = 0; i < FIELD_CELLS; i++) {
+        float straws = nest->restField[i * 2 + 1];
+        if (straws <= 0.0f) continue;
+
+        float dx = min.x + ((i % GPU_NEST_FIELD_SIZE) + 0.5f) * cellWidth - footprint.position.x;
+        float dz = min.z + ((i / GPU_NEST_FIELD_SIZE) + 0.5f) * cellDepth - footprint.position.z;
+        float distance = sqrtf(dx * dx + dz * dz);
+        if (distance >= footprint.radius) continue;
+
+        float weight = 1.0f - distance / footprint.radius;
+        float restHeight = nest->restField[i * 2] / straws;
+        float compression = nest->springField[i * 2] / straws;
+        float velocity = nest->springField[i * 2 + 1] / straws;
+        AddHayContact(&contact, egg, weight, restHeight, compression, velocity, straws, deltaTime);
+    }
+
+    FinishHayContact(&contact, deltaTime);
+    return contact;
+}
+
+void DrawGpuNest(GpuNest* nest, Vector3 cameraPosition) {
+    if (!nest->ready) return;
+
+    GLStateSnapshot state = SaveGLState();
+
+    Matrix modelView = MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview());
+    Matrix mvp = MatrixMultiply(modelView, rlGetMatrixProjection());
+
+    glUseProgram(nest->drawProgram);
+    glUniformMatrix4fv(nest->mvpLoc, 1, GL_FALSE, MatrixToFloatV(mvp).v);
+    glUniform3f(nest->cameraPositionLoc, cameraPosition.x, cameraPosition.y, cameraPosition.z);
+    glUniform1f(nest->renderAheadLoc, nest->renderAhead);
+    glBindVertexArray(nest->instanceVao[nest->current]);
+
+    // Ribbons turn with the camera, so their winding does too
+    rlDisableBackfaceCulling();
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 2 * GPU_NEST_SEGMENTS, nest->count);
+    rlEnableBackfaceCulling();
+
+    RestoreGLState(&state);
+}
+
+void UnloadGpuNest(GpuNest* nest) {
+    for (int i = 0; i < 2; i++) {
+        if (nest->readbackFences[i] != NULL) glDeleteSync((GLsync)nest->readbackFences[i]);
+    }
+    glDeleteBuffers(2, nest->readbackBuffers);
+    glDeleteFramebuffers(1, &nest->fieldFramebuffer);
+    glDeleteTextures(1, &nest->fieldTexture);
+    glDeleteVertexArrays(2, nest->pointVao);
+    glDeleteVertexArrays(2, nest->instanceVao);
+    glDeleteBuffers(2, nest->stateBuffers);
+    glDeleteBuffers(1, &nest->restBuffer);
+    if (nest->simulateProgram != 0) glDeleteProgram(nest->simulateProgram);
+    if (nest->drawProgram != 0) glDeleteProgram(nest->drawProgram);
+    if (nest->fieldProgram != 0) glDeleteProgram(nest->fieldProgram);
+    nest->ready = false;
+}
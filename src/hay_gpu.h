@@ -0,0 +1,65 @@
+#ifndef HAY_GPU_H
+#define HAY_GPU_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include "hay.h"
+
+#define GPU_NEST_MAX_EGGS 4         // Matches MAX_EGGS in hay_simulate.vs
+#define GPU_NEST_FIELD_SIZE 32      // Contact grid cells per side over the nest bounds
+#define GPU_NEST_SEGMENTS 8         // Curve points per straw
+
+// Straw simulation and drawing kept entirely on the GPU. The straw springs are
+// stepped with transform feedback, then summed per cell of a small grid that
+// comes back to the CPU for egg contact without ever waiting on the GPU.
+typedef struct {
+    bool ready;                         // False if the GL objects couldn't be created
+    int count;
+
+    unsigned int restBuffer;            // Packed HayPiece array, never rewritten
+    unsigned int stateBuffers[2];       // Compression and its velocity per straw, ping-ponged every step
+    int current;                        // State buffer holding the latest step
+
+    unsigned int pointVao[2];           // One vertex per straw, reads stateBuffers[i]
+    unsigned int instanceVao[2];        // One instance per straw, reads stateBuffers[i]
+
+    unsigned int simulateProgram;
+    unsigned int drawProgram;
+    unsigned int fieldProgram;
+    int eggsLoc;
+    int eggCountLoc;
+    int deltaTimeLoc;
+    int mvpLoc;
+    int cameraPositionLoc;
+    int renderAheadLoc;
+
+    // Spring grid, RG32F: sum of compression and of its velocity per cell
+    unsigned int fieldTexture;
+    unsigned int fieldFramebuffer;
+    unsigned int readbackBuffers[2];    // Pixel pack buffers, read once their fence signals
+    void* readbackFences[2];
+    int readbackSlot;                   // Buffer the next readback goes to
+
+    float springField[GPU_NEST_FIELD_SIZE * GPU_NEST_FIELD_SIZE * 2];  // Latest completed readback
+    float restField[GPU_NEST_FIELD_SIZE * GPU_NEST_FIELD_SIZE * 2];    // Sum of rest heights, straw count
+
+    float renderAhead;                  // Time since the last step, straws are drawn that far along
+} GpuNest;
+
+// Upload a nest. The CPU copy is not referenced afterwards.
+GpuNest CreateGpuNest(const HayPiece* hayPieces, int count);
+
+// Step the straw springs under up to GPU_NEST_MAX_EGGS eggs, like UpdateHayPhysics,
+// and queue a readback of the spring grid
+void UpdateGpuNest(GpuNest* nest, const CollisionSphere* eggs, int eggCount, float deltaTime);
+
+// The contact UpdateHayPhysics would sum, from the last spring grid that came
+// back. Straws in a cell count as one at the cell center with the cell's mean state.
+HayContact GatherGpuNestContact(const GpuNest* nest, const HayEgg* egg, float deltaTime);
+
+// Draw the straws as ribbons facing cameraPosition, inside BeginMode3D
+void DrawGpuNest(GpuNest* nest, Vector3 cameraPosition);
+
+void UnloadGpuNest(GpuNest* nest);
+
+#endif // HAY_GPU_H
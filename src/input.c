@@ -0,0 +1,121 @@
+#include "input.h"
+#include <string.h>
+
+// Trace layout, little-endian:
+//   header: "APIN", u32 version, u32 seed
+//   frame:  f32 deltaTime, f32 mouse x/y, f32 delta x/y, f32 wheel, u8 flags
+#define INPUT_TRACE_MAGIC "APIN"
+#define INPUT_TRACE_VERSION 1
+#define INPUT_FRAME_SIZE 25
+
+static void PutU32(unsigned char* out, unsigned int value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = (value >> 24) & 0xFF;
+}
+
+static unsigned int GetU32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8) |
+           ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+static void PutF32(unsigned char* out, float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    PutU32(out, bits);
+}
+
+static float GetF32(const unsigned char* in) {
+    unsigned int bits = GetU32(in);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+InputSource OpenInputSource(InputMode mode, const char* path, unsigned int seed, bool fixedStep) {
+    InputSource source = { .mode = mode, .seed = seed, .fixedStep = fixedStep };
+    if (mode == INPUT_LIVE) return source;
+
+    unsigned char header[12];
+    if (mode == INPUT_RECORD) {
+        source.file = fopen(path, "wb");
+        if (source.file != NULL) {
+            memcpy(header, INPUT_TRACE_MAGIC, 4);
+            PutU32(header + 4, INPUT_TRACE_VERSION);
+            PutU32(header + 8, seed);
+            fwrite(header, 1, sizeof(header), source.file);
+        }
+    } else {
+        source.file = fopen(path, "rb");
+        if (source.file != NULL) {
+            if (fread(header, 1, sizeof(header), source.file) != sizeof(header) ||
+                memcmp(header, INPUT_TRACE_MAGIC, 4) != 0 ||
+                GetU32(header + 4) != INPUT_TRACE_VERSION) {
+                TraceLog(LOG_WARNING, "INPUT: [%s] is not a valid input trace", path);
+                fclose(source.file);
+                source.file = NULL;
+            } else {
+                source.seed = GetU32(header + 8);
+            }
+        }
+    }
+
+    if (source.file == NULL) {
+        TraceLog(LOG_WARNING, "INPUT: Failed to open [%s], using live input", path);
+        source.mode = INPUT_LIVE;
+    }
+    return source;
+}
+
+static FrameInput ReadLiveInput(void) {
+    FrameInput input = {
+        .deltaTime = GetFrameTime(),
+        .mousePosition = GetMousePosition(),
+        .mouseDelta = GetMouseDelta(),
+        .mouseWheel = GetMouseWheelMove()
+    };
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) input.flags |= INPUT_MOUSE_LEFT_DOWN;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) input.flags |= INPUT_MOUSE_LEFT_PRESSED;
+    if (IsKeyPressed(KEY_L)) input.flags |= INPUT_KEY_L_PRESSED;
+    if (IsKeyPressed(KEY_K)) input.flags |= INPUT_KEY_K_PRESSED;
+    return input;
+}
+
+FrameInput PollFrameInput(InputSource* source) {
+    FrameInput input = {0};
+    unsigned char frame[INPUT_FRAME_SIZE];
+
+    if (source->mode == INPUT_REPLAY) {
+        if (source->finished || fread(frame, 1, sizeof(frame), source->file) != sizeof(frame)) {
+            source->finished = true;
+            return input;
+        }
+        input.deltaTime = GetF32(frame);
+        input.mousePosition = (Vector2){ GetF32(frame + 4), GetF32(frame + 8) };
+        input.mouseDelta = (Vector2){ GetF32(frame + 12), GetF32(frame + 16) };
+        input.mouseWheel = GetF32(frame + 20);
+        input.flags = frame[24];
+        if (source->fixedStep) input.deltaTime = INPUT_FIXED_STEP;
+    } else {
+        input = ReadLiveInput();
+        if (source->mode == INPUT_RECORD) {
+            PutF32(frame, input.deltaTime);
+            PutF32(frame + 4, input.mousePosition.x);
+            PutF32(frame + 8, input.mousePosition.y);
+            PutF32(frame + 12, input.mouseDelta.x);
+            PutF32(frame + 16, input.mouseDelta.y);
+            PutF32(frame + 20, input.mouseWheel);
+            frame[24] = input.flags;
+            fwrite(frame, 1, sizeof(frame), source->file);
+        }
+    }
+
+    source->frameCount++;
+    return input;
+}
+
+void CloseInputSource(InputSource* source) {
+    if (source->file != NULL) fclose(source->file);
+    source->file = NULL;
+}
@@ -0,0 +1,49 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define INPUT_FIXED_STEP (1.0f / 60.0f)
+
+// FrameInput.flags
+#define INPUT_MOUSE_LEFT_DOWN       (1 << 0)
+#define INPUT_MOUSE_LEFT_PRESSED    (1 << 1)
+#define INPUT_KEY_L_PRESSED         (1 << 2)
+#define INPUT_KEY_K_PRESSED         (1 << 3)
+
+// Everything the game reads from the user in one frame
+typedef struct {
+    float deltaTime;
+    Vector2 mousePosition;
+    Vector2 mouseDelta;
+    float mouseWheel;
+    unsigned char flags;
+} FrameInput;
+
+typedef enum {
+    INPUT_LIVE,
+    INPUT_RECORD,       // Live input, also written to a trace file
+    INPUT_REPLAY        // Input read back from a trace file
+} InputMode;
+
+typedef struct {
+    InputMode mode;
+    FILE* file;
+    unsigned int seed;  // RNG seed of the session, stored in the trace
+    bool fixedStep;     // Replay with INPUT_FIXED_STEP instead of the recorded deltas
+    bool finished;      // Replay reached the end of the trace
+    int frameCount;
+} InputSource;
+
+// Open an input source. For INPUT_REPLAY the seed is read from the trace,
+// otherwise it is written to it. Falls back to INPUT_LIVE if the file can't be opened.
+InputSource OpenInputSource(InputMode mode, const char* path, unsigned int seed, bool fixedStep);
+
+// Gather (or replay) the input of the next frame
+FrameInput PollFrameInput(InputSource* source);
+
+void CloseInputSource(InputSource* source);
+
+#endif // INPUT_H
@@ -1,10 +1,15 @@
 #include "light.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include <math.h>
+#include <string.h>
 
-LightComponent CreateLight(Vector3 position, Vector3 color, float intensity) {
+LightComponent CreateLight(Vector3 position, Vector3 color, float intensity, float range) {
     LightComponent light = {0};
     light.position = position;
     light.color = color;
     light.intensity = intensity;
+    light.range = range;
     return light;
 }
 
@@ -13,3 +18,260 @@ void UpdateLight(LightComponent* light, Vector3 position, Vector3 color, float i
     light->color = color;
     light->intensity = intensity;
 }
+
+static Texture2D LoadFloatTexture(float* pixels, int width, int height, int format) {
+    Image image = {
+        .data = pixels,
+        .width = width,
+        .height = height,
+        .mipmaps = 1,
+        .format = format
+    };
+    return LoadTextureFromImage(image);
+}
+
+LightList CreateLightList(int maxWidth, int maxHeight) {
+    LightList list = {0};
+    list.maxTilesX = (maxWidth + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    list.maxTilesY = (maxHeight + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    int maxTiles = list.maxTilesX * list.maxTilesY;
+
+    list.data = (float*)MemAlloc(MAX_LIGHTS * 2 * 4 * sizeof(float));
+    list.grid = (float*)MemAlloc(maxTiles * 4 * sizeof(float));
+    list.indices = (float*)MemAlloc(LIGHT_INDEX_TEXTURE_WIDTH * LIGHT_INDEX_TEXTURE_HEIGHT * sizeof(float));
+
+    list.dataTexture = LoadFloatTexture(list.data, MAX_LIGHTS, 2, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    list.gridTexture = LoadFloatTexture(list.grid, list.maxTilesX, list.maxTilesY, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+    list.indexTexture = LoadFloatTexture(list.indices, LIGHT_INDEX_TEXTURE_WIDTH, LIGHT_INDEX_TEXTURE_HEIGHT,
+                                         PIXELFORMAT_UNCOMPRESSED_R32);
+
+    TrackCpuMemory(MEMORY_LIGHTS, (MAX_LIGHTS * 2 * 4 + maxTiles * 4 +
+                                   LIGHT_INDEX_TEXTURE_WIDTH * LIGHT_INDEX_TEXTURE_HEIGHT) * sizeof(float));
+    TrackTextureMemory(MEMORY_LIGHTS, list.dataTexture);
+    TrackTextureMemory(MEMORY_LIGHTS, list.gridTexture);
+    TrackTextureMemory(MEMORY_LIGHTS, list.indexTexture);
+    return list;
+}
+
+int AddLight(LightList* list, LightComponent light) {
+    if (list->count >= MAX_LIGHTS) {
+        TraceLog(LOG_WARNING, "LIGHT: Light list full, ignoring light");
+        return -1;
+    }
+    list->lights[list->count] = light;
+    return list->count++;
+}
+
+static int ClampTile(int tile, int tileCount) {
+    if (tile < 0) return 0;
+    if (tile >= tileCount) return tileCount - 1;
+    return tile;
+}
+
+// Screen-space tile rectangle touched by a light's sphere of influence.
+// Returns false if the light cannot affect any pixel.
+static bool GetLightTileBounds(LightComponent light, Matrix view, float projX, float projY,
+                               int width, int height, int tilesX, int tilesY,
+                               int* minX, int* minY, int* maxX, int* maxY) {
+    Vector3 center = Vector3Transform(light.position, view);
+    float range = light.range;
+    float nearPlane = (float)RL_CULL_DISTANCE_NEAR;
+
+    // View space looks down -Z
+    if (-center.z + range < nearPlane) return false;
+
+    if (-center.z - range < nearPlane) {
+        // Sphere crosses the near plane, it may cover any pixel
+        *minX = 0;
+        *minY = 0;
+        *maxX = tilesX - 1;
+        *maxY = tilesY - 1;
+        return true;
+    }
+
+    // Project the corners of the sphere's view-space bounding box
+    float ndcMinX = INFINITY, ndcMinY = INFINITY;
+    float ndcMaxX = -INFINITY, ndcMaxY = -INFINITY;
+    for (int i = 0; i < 8; i++) {
+        float x = center.x + ((i & 1) ? range : -range);
+        float y = center.y + ((i & 2) ? range : -range);
+        float depth = -center.z + ((i & 4) ? range : -range);
+        float ndcX = x * projX / depth;
+        float ndcY = y * projY / depth;
+        ndcMinX = fminf(ndcMinX, ndcX);
+        ndcMaxX = fmaxf(ndcMaxX, ndcX);
+        ndcMinY = fminf(ndcMinY, ndcY);
+        ndcMaxY = fmaxf(ndcMaxY, ndcY);
+    }
+
+    if (ndcMaxX < -1.0f || ndcMinX > 1.0f || ndcMaxY < -1.0f || ndcMinY > 1.0f) return false;
+
+    // Bottom-up pixel coordinates, matching gl_FragCoord
+    *minX = (int)((ndcMinX * 0.5f + 0.5f) * width) / LIGHT_TILE_SIZE;
+    *maxX = (int)((ndcMaxX * 0.5f + 0.5f) * width) / LIGHT_TILE_SIZE;
+    *minY = (int)((ndcMinY * 0.5f + 0.5f) * height) / LIGHT_TILE_SIZE;
+    *maxY = (int)((ndcMaxY * 0.5f + 0.5f) * height) / LIGHT_TILE_SIZE;
+
+    *minX = ClampTile(*minX, tilesX);
+    *maxX = ClampTile(*maxX, tilesX);
+    *minY = ClampTile(*minY, tilesY);
+    *maxY = ClampTile(*maxY, tilesY);
+    return true;
+}
+
+void UpdateLightList(LightList* list, Camera3D camera, int width, int height, MemArena* scratch) {
+    list->tilesX = (width + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    list->tilesY = (height + LIGHT_TILE_SIZE - 1) / LIGHT_TILE_SIZE;
+    if (list->tilesX > list->maxTilesX) list->tilesX = list->maxTilesX;
+    if (list->tilesY > list->maxTilesY) list->tilesY = list->maxTilesY;
+    int tileCount = list->tilesX * list->tilesY;
+
+    int* tileCounts = (int*)ArenaAlloc(scratch, tileCount * sizeof(int));
+    if (tileCounts == NULL) return;  // Keep last frame's lists
+
+    // Same projection BeginMode3D sets up
+    Matrix view = GetCameraMatrix(camera);
+    float projY = 1.0f / tanf(camera.fovy * DEG2RAD * 0.5f);
+    float projX = projY / ((float)width / (float)height);
+
+    int bounds[MAX_LIGHTS][4];
+    bool visible[MAX_LIGHTS];
+
+    for (int t = 0; t < tileCount; t++) tileCounts[t] = 0;
+
+    // Pass 1: light data and per-tile counts
+    for (int i = 0; i < list->count; i++) {
+        LightComponent light = list->lights[i];
+        float* texel = &list->data[4 * i];
+        float* texel2 = &list->data[4 * (MAX_LIGHTS + i)];
+        texel[0] = light.position.x;
+        texel[1] = light.position.y;
+        texel[2] = light.position.z;
+        texel[3] = light.range;
+        texel2[0] = light.color.x;
+        texel2[1] = light.color.y;
+        texel2[2] = light.color.z;
+        texel2[3] = light.intensity;
+
+        visible[i] = light.intensity > 0.0f &&
+                     GetLightTileBounds(light, view, projX, projY, width, height,
+                                        list->tilesX, list->tilesY,
+                                        &bounds[i][0], &bounds[i][1], &bounds[i][2], &bounds[i][3]);
+        if (!visible[i]) continue;
+
+        for (int ty = bounds[i][1]; ty <= bounds[i][3]; ty++) {
+            for (int tx = bounds[i][0]; tx <= bounds[i][2]; tx++) {
+                tileCounts[ty * list->tilesX + tx]++;
+            }
+        }
+    }
+
+    // Prefix sum into per-tile offsets, truncating tiles that overflow the index texture
+    const int capacity = LIGHT_INDEX_TEXTURE_WIDTH * LIGHT_INDEX_TEXTURE_HEIGHT;
+    int total = 0;
+    for (int ty = 0; ty < list->tilesY; ty++) {
+        for (int tx = 0; tx < list->tilesX; tx++) {
+            int tile = ty * list->tilesX + tx;
+            int count = tileCounts[tile];
+            if (total + count > capacity) count = capacity - total;
+
+            float* cell = &list->grid[4 * (ty * list->maxTilesX + tx)];
+            cell[0] = (float)total;
+            cell[1] = (float)count;
+            tileCounts[tile] = 0;  // Reused as the fill cursor below
+            total += count;
+        }
+    }
+
+    // Pass 2: scatter light indices into their tiles
+    for (int i = 0; i < list->count; i++) {
+        if (!visible[i]) continue;
+        for (int ty = bounds[i][1]; ty <= bounds[i][3]; ty++) {
+            for (int tx = bounds[i][0]; tx <= bounds[i][2]; tx++) {
+                int tile = ty * list->tilesX + tx;
+                float* cell = &list->grid[4 * (ty * list->maxTilesX + tx)];
+                if (tileCounts[tile] >= (int)cell[1]) continue;
+                list->indices[(int)cell[0] + tileCounts[tile]++] = (float)i;
+            }
+        }
+    }
+
+    UpdateTexture(list->dataTexture, list->data);
+    UpdateTexture(list->gridTexture, list->grid);
+    int rows = (total + LIGHT_INDEX_TEXTURE_WIDTH - 1) / LIGHT_INDEX_TEXTURE_WIDTH;
+    if (rows > 0) {
+        UpdateTextureRec(list->indexTexture,
+                         (Rectangle){ 0, 0, LIGHT_INDEX_TEXTURE_WIDTH, (float)rows },
+                         list->indices);
+    }
+}
+
+Shader LoadLitShader(const char* vsFileName, const char* fsFileName) {
+    char* vsText = (vsFileName != NULL) ? LoadFileText(vsFileName) : NULL;
+    char* fsText = LoadFileText(fsFileName);
+    char* lightText = LoadFileText(LIGHT_SHADER_FILE);
+
+    char* include = (fsText != NULL) ? strstr(fsText, LIGHT_SHADER_INCLUDE) : NULL;
+    char* source = NULL;
+    if (include != NULL && lightText != NULL) {
+        size_t before = (size_t)(include - fsText);
+        const char* after = include + strlen(LIGHT_SHADER_INCLUDE);
+        size_t lightLength = strlen(lightText);
+        source = (char*)MemAlloc(before + lightLength + strlen(after) + 1);
+        memcpy(source, fsText, before);
+        memcpy(source + before, lightText, lightLength);
+        strcpy(source + before + lightLength, after);
+    } else if (fsText != NULL) {
+        TraceLog(LOG_WARNING, "LIGHT: [%s] Failed to include %s", fsFileName, LIGHT_SHADER_FILE);
+    }
+
+    Shader shader = LoadShaderFromMemory(vsText, (source != NULL) ? source : fsText);
+
+    MemFree(source);
+    if (vsText != NULL) UnloadFileText(vsText);
+    if (fsText != NULL) UnloadFileText(fsText);
+    if (lightText != NULL) UnloadFileText(lightText);
+    return shader;
+}
+
+void BindLightList(LightList* list, Shader shader) {
+    // Sampler uniforms hold texture units, the textures are bound by EnableLightList
+    int dataUnit = LIGHT_DATA_UNIT;
+    int gridUnit = LIGHT_GRID_UNIT;
+    int indexUnit = LIGHT_INDEX_UNIT;
+    SetShaderValue(shader, GetShaderLocation(shader, "lightData"), &dataUnit, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "lightGrid"), &gridUnit, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "lightIndices"), &indexUnit, SHADER_UNIFORM_INT);
+
+    int tileSize = LIGHT_TILE_SIZE;
+    int indexWidth = list->indexTexture.width;
+    SetShaderValue(shader, GetShaderLocation(shader, "lightTileSize"), &tileSize, SHADER_UNIFORM_INT);
+    SetShaderValue(shader, GetShaderLocation(shader, "lightIndexWidth"), &indexWidth, SHADER_UNIFORM_INT);
+}
+
+void EnableLightList(LightList* list) {
+    rlActiveTextureSlot(LIGHT_DATA_UNIT);
+    rlEnableTexture(list->dataTexture.id);
+    rlActiveTextureSlot(LIGHT_GRID_UNIT);
+    rlEnableTexture(list->gridTexture.id);
+    rlActiveTextureSlot(LIGHT_INDEX_UNIT);
+    rlEnableTexture(list->indexTexture.id);
+    rlActiveTextureSlot(0);
+}
+
+void DisableLightList(void) {
+    for (int unit = LIGHT_DATA_UNIT; unit <= LIGHT_INDEX_UNIT; unit++) {
+        rlActiveTextureSlot(unit);
+        rlDisableTexture();
+    }
+    rlActiveTextureSlot(0);
+}
+
+void UnloadLightList(LightList* list) {
+    UnloadTexture(list->dataTexture);
+    UnloadTexture(list->gridTexture);
+    UnloadTexture(list->indexTexture);
+    MemFree(list->data);
+    MemFree(list->grid);
+    MemFree(list->indices);
+}
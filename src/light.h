@@ -2,17 +2,75 @@
 #define LIGHT_H
 
 #include "raylib.h"
+#include "arena.h"
+
+#define MAX_LIGHTS 64
+#define LIGHT_TILE_SIZE 32              // Screen tile edge in pixels
+#define LIGHT_INDEX_TEXTURE_WIDTH 256
+#define LIGHT_INDEX_TEXTURE_HEIGHT 128  // Room for 32768 tile/light pairs
+
+// Texture units of the light textures, past the 12 material maps DrawMesh binds
+#define LIGHT_DATA_UNIT 12
+#define LIGHT_GRID_UNIT 13
+#define LIGHT_INDEX_UNIT 14
+
+// Shared GLSL for lit shaders, spliced in place of the include line
+#define LIGHT_SHADER_FILE "shaders/point_lights.glsl"
+#define LIGHT_SHADER_INCLUDE "#include \"point_lights.glsl\""
 
 typedef struct {
     Vector3 position;
     Vector3 color;
     float intensity;
+    float range;        // Distance at which the light has faded out completely
 } LightComponent;
 
+typedef struct {
+    LightComponent lights[MAX_LIGHTS];
+    int count;
+
+    int tilesX;         // Tile grid of the current frame
+    int tilesY;
+    int maxTilesX;      // Tile grid at full resolution
+    int maxTilesY;
+
+    // GPU copies, rewritten once per frame
+    Texture2D dataTexture;      // MAX_LIGHTS x 2 RGBA32F: position + range, color + intensity
+    Texture2D gridTexture;      // maxTilesX x maxTilesY RGBA32F: offset, count
+    Texture2D indexTexture;     // R32F light indices, packed per tile
+
+    // CPU staging
+    float* data;
+    float* grid;
+    float* indices;
+} LightList;
+
 // Initialize a light component
-LightComponent CreateLight(Vector3 position, Vector3 color, float intensity);
+LightComponent CreateLight(Vector3 position, Vector3 color, float intensity, float range);
 
 // Update light properties
 void UpdateLight(LightComponent* light, Vector3 position, Vector3 color, float intensity);
 
+// Create a light list whose tile grid covers a render target of up to maxWidth x maxHeight
+LightList CreateLightList(int maxWidth, int maxHeight);
+
+// Add a light, returns its index or -1 if the list is full
+int AddLight(LightList* list, LightComponent light);
+
+// Cull lights into screen tiles for a width x height render and upload the result.
+// Per-tile counters are allocated from scratch.
+void UpdateLightList(LightList* list, Camera3D camera, int width, int height, MemArena* scratch);
+
+// Load a shader whose fragment source includes LIGHT_SHADER_FILE
+Shader LoadLitShader(const char* vsFileName, const char* fsFileName);
+
+// Point a lit shader's light samplers at the light texture units
+void BindLightList(LightList* list, Shader shader);
+
+// Bind the list's textures to their units for the lit draws that follow
+void EnableLightList(LightList* list);
+void DisableLightList(void);
+
+void UnloadLightList(LightList* list);
+
 #endif // LIGHT_H
@@ -3,11 +3,20 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 #include <rlgl.h>
 #include "hay.h"
+#include "hay_gpu.h"
 #include "egg.h" 
 #include "constants.h"
 #include "terrarium.h"
+#include "resolution.h"
+#include "render_queue.h"
+#include "oit.h"
+#include "input.h"
+#include "arena.h"
+#include "telemetry.h"
 
 typedef enum {
     SCREEN_WELCOME,
@@ -20,13 +29,80 @@ typedef struct {
     int colorType;
 } EggButton;
 
-int main(void) {
+typedef struct {
+    HayPiece* hayPieces;
+    int count;
+    Vector3 center;
+    float radius;
+    float renderAhead;      // Time since the last physics tick
+} NestDrawData;
+
+static void DrawSkyboxItem(void* data, Camera3D camera) {
+    (void)camera;
+    DrawModel(*(Model*)data, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+}
+
+static void DrawNestItem(void* data, Camera3D camera) {
+    (void)camera;
+    NestDrawData* nest = (NestDrawData*)data;
+    for (int i = 0; i < nest->count; i++) {
+        if (Vector3Distance(GetHayStartPosition(&nest->hayPieces[i]), nest->center) < nest->radius) {
+            DrawHayPiece(nest->hayPieces[i], nest->renderAhead);
+        }
+    }
+}
+
+static void DrawGpuNestItem(void* data, Camera3D camera) {
+    DrawGpuNest((GpuNest*)data, camera.position);
+}
+
+int main(int argc, char** argv) {
     const int screenWidth = 800;
     const int screenHeight = 600;
 
+    // Command line: --record <trace> | --replay <trace> [--fixed-step] [--gpu-hay] [--telemetry-socket]
+    InputMode inputMode = INPUT_LIVE;
+    const char* tracePath = NULL;
+    bool fixedStep = false;
+    bool gpuHay = false;
+    bool telemetrySocket = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            inputMode = INPUT_RECORD;
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            inputMode = INPUT_REPLAY;
+            tracePath = argv[++i];
+        } else if (strcmp(argv[i], "--fixed-step") == 0) {
+            fixedStep = true;
+        } else if (strcmp(argv[i], "--gpu-hay") == 0) {
+            gpuHay = true;
+        } else if (strcmp(argv[i], "--telemetry-socket") == 0) {
+            telemetrySocket = true;
+        }
+    }
+
     // Initialize window
     InitWindow(screenWidth, screenHeight, "Space Terrarium");
-    SetTargetFPS(60);
+
+    // Replays seed the RNG from the trace so the nest is rebuilt identically
+    InputSource input = OpenInputSource(inputMode, tracePath, (unsigned int)time(NULL), fixedStep);
+    SetRandomSeed(input.seed);
+
+    // A fixed-step replay is a benchmark, run it as fast as possible
+    SetTargetFPS((input.mode == INPUT_REPLAY && input.fixedStep) ? 0 : 60);
+
+    // The nest is built first, straight after seeding, and nothing runs without it
+    MemArena nestArena = CreateArena(NEST_ARENA_SIZE, MEMORY_NEST);
+    HayPiece* hayPieces = InitializeNest(&nestArena, NUM_NEST_PIECES);
+    if (hayPieces == NULL) {
+        TraceLog(LOG_ERROR, "NEST: Failed to allocate %d straws", NUM_NEST_PIECES);
+        DestroyArena(&nestArena);
+        CloseInputSource(&input);
+        CloseWindow();
+        return 1;
+    }
+    MemPool petPool = CreatePool(sizeof(PhysicsObject), MAX_PETS, MEMORY_PETS);
 
     GameScreen currentScreen = SCREEN_WELCOME;
 
@@ -38,23 +114,42 @@ int main(void) {
     };
 
     // Load shaders
-    Shader eggShader = LoadShader("shaders/egg_vertex.glsl", "shaders/egg_fragment.glsl");
-    Shader glassShader = LoadShader("shaders/glass_vertex.glsl", "shaders/glass_fragment.glsl");
-    Shader groundShader = LoadShader("shaders/ground_vertex.glsl", "shaders/ground_fragment.glsl");
+    Shader eggShader = LoadLitShader("shaders/egg_vertex.glsl", "shaders/egg_fragment.glsl");
+    Shader glassShader = LoadLitShader("shaders/glass_vertex.glsl", "shaders/glass_fragment.glsl");
+    Shader groundShader = LoadLitShader("shaders/ground_vertex.glsl", "shaders/ground_fragment.glsl");
     Shader spaceShader = LoadShader("shaders/space_vertex.glsl", "shaders/space_background.fs");
 
     // Create skybox
     Mesh skyMesh = GenMeshSphere(1000.0f, 64, 64);
     Model skybox = LoadModelFromMesh(skyMesh);
     skybox.materials[0].shader = spaceShader;
+    TrackModelMemory(MEMORY_RENDER, skybox);
 
     // Create a center point that everything will reference
     Vector3 centerPoint = (Vector3){ 0.0f, 0.0f, 0.0f };
 
+    // Scratch memory for a single frame, reset at the top of the loop
+    MemArena frameArena = CreateArena(FRAME_ARENA_SIZE, MEMORY_FRAME);
+
     // Initialize systems
-    HayPiece* hayPieces = InitializeNest();
     EggSystem eggSystem = InitializeEggSystem(eggShader);
     TerrariumSystem terrarium = InitializeTerrariumSystem(glassShader, groundShader);
+    BindTerrariumLights(&terrarium, eggShader);
+    NestDrawData nestDrawData = { hayPieces, NUM_NEST_PIECES, centerPoint, terrarium.glass.radius };
+
+    // Optionally simulate and draw the straws on the GPU, falling back to the CPU nest
+    GpuNest gpuNest = {0};
+    if (gpuHay) {
+        gpuNest = CreateGpuNest(hayPieces, NUM_NEST_PIECES);
+        gpuHay = gpuNest.ready;
+    }
+
+    // Draw items are collected each frame, then sorted by state and depth
+    RenderQueue renderQueue = {0};
+
+    // The 3D scene is rendered off-screen at a scale driven by frame time
+    DynamicResolution dynres = InitDynamicResolution(screenWidth, screenHeight, DYNRES_TARGET_FPS);
+    OITBuffers oit = InitOIT(dynres.target);
 
     // Camera setup centered on centerPoint
     Camera3D camera = {
@@ -74,19 +169,43 @@ int main(void) {
     float angleVertical = 0.3f;
     float rotationSpeed = 2.0f;
 
+    // Simulation clock, advanced by (possibly replayed) frame deltas
+    float elapsedTime = 0.0f;
+    float physicsAccumulator = 0.0f;
+
+    // Per-frame stats for external dashboards, see tools/telemetry_reader.c
+    Telemetry telemetry = OpenTelemetry(telemetrySocket);
+    TelemetryStats telemetryStats = { .version = TELEMETRY_VERSION };
+
+    // Wall-clock frame statistics, reported at the end of a replay
+    double totalFrameTime = 0.0;
+    float minFrameTime = INFINITY;
+    float maxFrameTime = 0.0f;
+
     while (!WindowShouldClose()) {
-        float deltaTime = GetFrameTime();
+        ResetArena(&frameArena);
+
+        FrameInput frameInput = PollFrameInput(&input);
+        if (input.finished) break;
+
+        float deltaTime = frameInput.deltaTime;
+        elapsedTime += deltaTime;
+
+        float frameTime = GetFrameTime();
+        totalFrameTime += frameTime;
+        minFrameTime = fminf(minFrameTime, frameTime);
+        maxFrameTime = fmaxf(maxFrameTime, frameTime);
+        float physicsTime = 0.0f;
 
         if (currentScreen == SCREEN_WELCOME) {
             // Welcome screen logic
-            Vector2 mousePoint = GetMousePosition();
+            Vector2 mousePoint = frameInput.mousePosition;
             
             for (int i = 0; i < 3; i++) {
                 if (CheckCollisionPointRec(mousePoint, eggButtons[i].bounds) && 
-                    IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+                    (frameInput.flags & INPUT_MOUSE_LEFT_PRESSED)) {
                     currentScreen = SCREEN_TERRARIUM;
-                    eggSystem.egg.colorType = eggButtons[i].colorType;
-                    SpawnEgg(&eggSystem, eggButtons[i].colorType);
+                    SpawnEgg(&eggSystem, &petPool, eggButtons[i].colorType);
                     DisableCursor();
                     break;
                 }
@@ -109,25 +228,40 @@ int main(void) {
         } else {
             // Terrarium screen logic
             // [Previous terrarium logic remains the same]
-            float wheel = GetMouseWheelMove();
+            float wheel = frameInput.mouseWheel;
             if (wheel != 0) {
                 cameraDistance -= wheel * zoomSpeed;
                 cameraDistance = Clamp(cameraDistance, minDistance, maxDistance);
             }
 
     
-            if (IsKeyPressed(KEY_L)) {
-                terrarium.internalLight.intensity += 2.0f;
+            LightComponent* internalLight = &terrarium.lights.lights[terrarium.internalLight];
+            if (frameInput.flags & INPUT_KEY_L_PRESSED) {
+                internalLight->intensity += 2.0f;
             }
-            if (IsKeyPressed(KEY_K)) {
-                terrarium.internalLight.intensity -= 2.0f;
-                terrarium.internalLight.intensity = fmax(0.0f, terrarium.internalLight.intensity);
+            if (frameInput.flags & INPUT_KEY_K_PRESSED) {
+                internalLight->intensity -= 2.0f;
+                internalLight->intensity = fmax(0.0f, internalLight->intensity);
             }
 
-            UpdateEggPhysics(&eggSystem, hayPieces, deltaTime);
+            // Physics runs at a fixed tick; the egg is drawn between the last two
+            double physicsStart = GetTime();
+            physicsAccumulator = fminf(physicsAccumulator + deltaTime, MAX_PHYSICS_STEPS * PHYSICS_STEP);
+            while (physicsAccumulator >= PHYSICS_STEP) {
+                if (gpuHay) {
+                    UpdateEggPhysicsGpu(&eggSystem, &gpuNest, PHYSICS_STEP);
+                } else {
+                    UpdateEggPhysics(&eggSystem, 1, hayPieces, NUM_NEST_PIECES, PHYSICS_STEP);
+                }
+                physicsAccumulator -= PHYSICS_STEP;
+            }
+            InterpolateEgg(&eggSystem, physicsAccumulator / PHYSICS_STEP);
+            nestDrawData.renderAhead = physicsAccumulator;
+            gpuNest.renderAhead = physicsAccumulator;
+            physicsTime = (float)(GetTime() - physicsStart);
 
-            if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-                Vector2 mouseDelta = GetMouseDelta();
+            if (frameInput.flags & INPUT_MOUSE_LEFT_DOWN) {
+                Vector2 mouseDelta = frameInput.mouseDelta;
                 angleHorizontal -= mouseDelta.x * rotationSpeed * deltaTime;
                 angleVertical -= mouseDelta.y * rotationSpeed * deltaTime;
                 angleVertical = Clamp(angleVertical, -1.5f, 1.5f);
@@ -139,52 +273,125 @@ int main(void) {
             camera.position = (Vector3){ x, y + 0.05f, z };
             camera.target = centerPoint;
 
-            BeginDrawing();
+            // Scale follows the real cost of a frame, not the simulated step
+            UpdateDynamicResolution(&dynres, frameTime);
+            UpdateTerrariumLights(&terrarium, camera,
+                                  GetDynamicResolutionWidth(&dynres), GetDynamicResolutionHeight(&dynres),
+                                  &frameArena);
+
+            float timeValue = elapsedTime;
+            SetShaderValue(spaceShader, GetShaderLocation(spaceShader, "time"), 
+                         &timeValue, SHADER_UNIFORM_FLOAT);
+
+            // The skybox is drawn first, without depth, and never culled
+            RenderState skyState = { BLEND_ALPHA, false, false, false };
+
+            BeginRenderQueue(&renderQueue, camera, &frameArena);
+            SubmitRenderItem(&renderQueue, RENDER_LAYER_BACKGROUND, skyState, spaceShader.id,
+                             centerPoint, DrawSkyboxItem, &skybox);
+            if (gpuHay) {
+                SubmitRenderItem(&renderQueue, RENDER_LAYER_OPAQUE, DefaultRenderState(), gpuNest.drawProgram,
+                                 centerPoint, DrawGpuNestItem, &gpuNest);
+            } else {
+                SubmitRenderItem(&renderQueue, RENDER_LAYER_OPAQUE, DefaultRenderState(), rlGetShaderIdDefault(),
+                                 centerPoint, DrawNestItem, &nestDrawData);
+            }
+            SubmitEgg(&eggSystem, &renderQueue);
+            SubmitTerrariumSystem(&terrarium, &renderQueue);
+
+            BeginDynamicResolution(&dynres);
                 ClearBackground(BLACK);
 
+                EnableTerrariumLights(&terrarium);
                 BeginMode3D(camera);
-                    // [Previous drawing code remains the same]
-                    rlDisableBackfaceCulling();
-                    rlDisableDepthMask();
-                    rlDisableDepthTest(); 
-
-                    float timeValue = GetTime();
-                    SetShaderValue(spaceShader, GetShaderLocation(spaceShader, "time"), 
-                                 &timeValue, SHADER_UNIFORM_FLOAT);
-                    
-                    DrawModel(skybox, centerPoint, 1.0f, WHITE);
-                    
-                    rlEnableDepthTest();
-                    rlEnableBackfaceCulling();
-                    rlEnableDepthMask();
-
-                    for (int i = 0; i < NUM_HAY_PIECES + TOP_LAYER_PIECES; i++) {
-                        if (Vector3Distance(hayPieces[i].startPos, centerPoint) < terrarium.glass.radius) {
-                            DrawHayPiece(hayPieces[i]);
-                        }
-                    }
-
-                    DrawEgg(&eggSystem, camera, eggShader);
-                    DrawTerrariumSystem(&terrarium, camera);
+                    DrawRenderQueueLayer(&renderQueue, RENDER_LAYER_BACKGROUND);
+                    DrawRenderQueueLayer(&renderQueue, RENDER_LAYER_OPAQUE);
+
+                    // Translucent surfaces need no sorting, they accumulate in any order
+                    BeginOIT(&oit);
+                        DrawRenderQueueLayer(&renderQueue, RENDER_LAYER_TRANSPARENT);
+                    EndOIT(&oit);
                 EndMode3D();
+                DisableTerrariumLights();
+
+                CompositeOIT(&oit, GetDynamicResolutionWidth(&dynres), GetDynamicResolutionHeight(&dynres));
+            EndDynamicResolution();
+
+            BeginDrawing();
+                ClearBackground(BLACK);
+
+                // Upscale the scene, then draw UI text at native resolution on top
+                DrawDynamicResolution(&dynres);
 
                 DrawText("Hold left mouse button and drag to rotate camera", 10, 10, 20, WHITE);
                 DrawText("Use mouse wheel to zoom in/out", 10, 30, 20, WHITE);
                 DrawText("Press SPACE to spawn egg", 10, 50, 20, WHITE);
                 DrawText("Press L/K to increase/decrease light", 10, 70, 20, WHITE);
+                DrawText(TextFormat("Render scale: %d%%", (int)(dynres.scale * 100.0f)), 10, 90, 20, WHITE);
+                DrawText(TextFormat("Items: %d  State changes: %d  Shader groups: %d",
+                                    renderQueue.stats.items, renderQueue.stats.stateChanges,
+                                    renderQueue.stats.shaderGroups), 10, 110, 20, WHITE);
+
+                // Memory per subsystem: reserved CPU bytes and estimated GPU bytes. The default
+                // font is proportional, so each column has its own x and numbers are right-aligned.
+                MemoryReport memory = GetMemoryReport();
+                for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++) {
+                    int y = 135 + 12 * i;
+                    const char* cpuText = TextFormat("CPU %.1f KB", memory.cpuBytes[i] / 1024.0f);
+                    DrawText(GetMemorySubsystemName(i), 10, y, 10, WHITE);
+                    DrawText(cpuText, 160 - MeasureText(cpuText, 10), y, 10, WHITE);
+                    const char* gpuText = TextFormat("GPU %.1f KB", memory.gpuBytes[i] / 1024.0f);
+                    DrawText(gpuText, 260 - MeasureText(gpuText, 10), y, 10, WHITE);
+                }
+                DrawText(TextFormat("Frame arena peak: %d bytes", (int)frameArena.peak),
+                         10, 135 + 12 * MEMORY_SUBSYSTEM_COUNT, 10, WHITE);
             EndDrawing();
         }
+
+        telemetryStats.frame = (uint32_t)input.frameCount;
+        telemetryStats.time = GetTime();
+        telemetryStats.frameTimeMs = 1000.0f * frameTime;
+        telemetryStats.physicsMs = 1000.0f * physicsTime;
+        telemetryStats.renderScale = dynres.scale;
+        telemetryStats.petCount = petPool.used;
+        telemetryStats.renderItems = renderQueue.stats.items;
+        telemetryStats.stateChanges = renderQueue.stats.stateChanges;
+        telemetryStats.shaderGroups = renderQueue.stats.shaderGroups;
+
+        MemoryReport memory = GetMemoryReport();
+        telemetryStats.memorySlots = MEMORY_SUBSYSTEM_COUNT;
+        for (int i = 0; i < MEMORY_SUBSYSTEM_COUNT; i++) {
+            snprintf(telemetryStats.memoryNames[i], TELEMETRY_NAME_SIZE, "%s", GetMemorySubsystemName(i));
+            telemetryStats.cpuBytes[i] = memory.cpuBytes[i];
+            telemetryStats.gpuBytes[i] = memory.gpuBytes[i];
+        }
+        PublishTelemetry(&telemetry, &telemetryStats);
+    }
+
+    if (input.mode == INPUT_REPLAY && input.frameCount > 0) {
+        printf("Replay: %d frames in %.3f s, avg %.3f ms, min %.3f ms, max %.3f ms\n",
+               input.frameCount, totalFrameTime, 1000.0 * totalFrameTime / input.frameCount,
+               1000.0f * minFrameTime, 1000.0f * maxFrameTime);
+        PrintMemoryReport(stdout, "");
+        printf("Frame arena peak: %zu of %zu bytes\n", frameArena.peak, frameArena.capacity);
     }
+    CloseInputSource(&input);
+    CloseTelemetry(&telemetry);
 
     // Cleanup
     UnloadModel(skybox);
-    free(hayPieces);
+    if (gpuHay) UnloadGpuNest(&gpuNest);
+    DestroyArena(&nestArena);
+    DestroyPool(&petPool);
     UnloadEggSystem(&eggSystem);
     UnloadShader(eggShader);
     UnloadShader(glassShader);
     UnloadShader(groundShader);
     UnloadShader(spaceShader);
     UnloadTerrariumSystem(&terrarium);
+    UnloadOIT(&oit);
+    UnloadDynamicResolution(&dynres);
+    DestroyArena(&frameArena);
     CloseWindow();
 
     return 0;
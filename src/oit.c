@@ -0,0 +1,87 @@
+#include "oit.h"
+#include <rlgl.h>
+#include <stdlib.h>
+#include "arena.h"
+
+static Texture2D LoadOITTexture(int width, int height) {
+    Texture2D texture = {
+        .width = width,
+        .height = height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R16G16B16A16
+    };
+    texture.id = rlLoadTexture(NULL, width, height, texture.format, 1);
+    return texture;
+}
+
+OITBuffers InitOIT(RenderTexture2D sceneTarget) {
+    OITBuffers oit = {0};
+    int width = sceneTarget.texture.width;
+    int height = sceneTarget.texture.height;
+
+    oit.accumTexture = LoadOITTexture(width, height);
+    oit.revealTexture = LoadOITTexture(width, height);
+    TrackTextureMemory(MEMORY_RENDER, oit.accumTexture);
+    TrackTextureMemory(MEMORY_RENDER, oit.revealTexture);
+    oit.sceneFramebuffer = sceneTarget.id;
+
+    oit.framebuffer = rlLoadFramebuffer();
+    rlFramebufferAttach(oit.framebuffer, oit.accumTexture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+    rlFramebufferAttach(oit.framebuffer, oit.revealTexture.id, RL_ATTACHMENT_COLOR_CHANNEL1, RL_ATTACHMENT_TEXTURE2D, 0);
+    // Translucent surfaces are depth tested against the opaque scene
+    rlFramebufferAttach(oit.framebuffer, sceneTarget.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+
+    if (!rlFramebufferComplete(oit.framebuffer)) {
+        TraceLog(LOG_WARNING, "OIT: Framebuffer [ID %i] is not complete", oit.framebuffer);
+    }
+
+    // Draw buffers are framebuffer state, so this sticks
+    rlEnableFramebuffer(oit.framebuffer);
+    rlActiveDrawBuffers(2);
+    rlDisableFramebuffer();
+
+    oit.compositeShader = LoadShader(0, "shaders/oit_composite.fs");
+    oit.revealTextureLoc = GetShaderLocation(oit.compositeShader, "revealTexture");
+
+    return oit;
+}
+
+void BeginOIT(OITBuffers* oit) {
+    rlDrawRenderBatchActive();
+    rlEnableFramebuffer(oit->framebuffer);
+
+    // Accumulation starts at zero, revealage at one. Both targets can share
+    // (0, 0, 0, 1) since accumulation alpha is never read. The depth mask keeps
+    // the clear from touching the shared depth buffer.
+    rlDisableDepthMask();
+    rlClearColor(0, 0, 0, 255);
+    rlClearScreenBuffers();
+    rlEnableDepthMask();
+
+    // Color: additive. Alpha: multiply destination by (1 - alpha).
+    rlSetBlendFactorsSeparate(RL_ONE, RL_ONE, RL_ZERO, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+}
+
+void EndOIT(OITBuffers* oit) {
+    rlDrawRenderBatchActive();
+    rlEnableFramebuffer(oit->sceneFramebuffer);
+}
+
+void CompositeOIT(OITBuffers* oit, int width, int height) {
+    Rectangle source = { 0.0f, 0.0f, (float)width, -(float)height };
+    Rectangle dest = { 0.0f, 0.0f, (float)oit->accumTexture.width, (float)oit->accumTexture.height };
+
+    BeginShaderMode(oit->compositeShader);
+        SetShaderValueTexture(oit->compositeShader, oit->revealTextureLoc, oit->revealTexture);
+        DrawTexturePro(oit->accumTexture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndShaderMode();
+}
+
+void UnloadOIT(OITBuffers* oit) {
+    // rlUnloadFramebuffer deletes the depth attachment, which belongs to the scene target
+    rlFramebufferAttach(oit->framebuffer, 0, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+    rlUnloadFramebuffer(oit->framebuffer);
+    rlUnloadTexture(oit->accumTexture.id);
+    rlUnloadTexture(oit->revealTexture.id);
+    UnloadShader(oit->compositeShader);
+}
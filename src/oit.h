@@ -0,0 +1,35 @@
+#ifndef OIT_H
+#define OIT_H
+
+#include <raylib.h>
+
+// Weighted blended order-independent transparency (McGuire & Bavoil 2013).
+// Translucent materials write to two targets in one unsorted pass:
+//   accumulation: rgb = sum(premultiplied color * weight)
+//   reveal:       r   = sum(alpha * weight), a = product(1 - alpha)
+// and a full-screen composite resolves them over the opaque scene.
+typedef struct {
+    unsigned int framebuffer;
+    Texture2D accumTexture;
+    Texture2D revealTexture;
+    unsigned int sceneFramebuffer;  // Target the opaque scene is rendered to
+    Shader compositeShader;
+    int revealTextureLoc;
+} OITBuffers;
+
+// Create the OIT targets sharing the depth buffer of sceneTarget
+OITBuffers InitOIT(RenderTexture2D sceneTarget);
+
+// Redirect drawing to the OIT targets, call inside BeginMode3D after opaque geometry
+void BeginOIT(OITBuffers* oit);
+
+// Return to the scene target
+void EndOIT(OITBuffers* oit);
+
+// Resolve into the scene target, call in 2D after EndMode3D. width x height is the
+// region of the targets that was rendered to.
+void CompositeOIT(OITBuffers* oit, int width, int height);
+
+void UnloadOIT(OITBuffers* oit);
+
+#endif // OIT_H
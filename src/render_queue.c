@@ -0,0 +1,128 @@
+#include "render_queue.h"
+#include <raymath.h>
+#include <rlgl.h>
+#include <stdlib.h>
+#include <string.h>
+
+RenderState DefaultRenderState(void) {
+    return (RenderState){
+        .blendMode = BLEND_ALPHA,
+        .depthTest = true,
+        .depthWrite = true,
+        .backfaceCulling = true
+    };
+}
+
+void BeginRenderQueue(RenderQueue* queue, Camera3D camera, MemArena* frameArena) {
+    queue->items = (RenderItem*)ArenaAlloc(frameArena, MAX_RENDER_ITEMS * sizeof(RenderItem));
+    queue->capacity = (queue->items != NULL) ? MAX_RENDER_ITEMS : 0;
+    queue->count = 0;
+    queue->camera = camera;
+    queue->sorted = false;
+    queue->stats = (RenderStats){0};
+}
+
+static unsigned int PackRenderState(RenderState state) {
+    unsigned int blend = (unsigned int)state.blendMode & 0xF;
+    return (blend << 3) | (state.depthTest << 2) | (state.depthWrite << 1) | state.backfaceCulling;
+}
+
+// Non-negative floats keep their order when compared as unsigned integers
+static unsigned int DepthBits(float depth) {
+    unsigned int bits;
+    if (depth < 0.0f) depth = 0.0f;
+    memcpy(&bits, &depth, sizeof(bits));
+    return bits;
+}
+
+void SubmitRenderItem(RenderQueue* queue, RenderLayer layer, RenderState state, unsigned int shaderId,
+                      Vector3 position, RenderDrawFunc draw, void* data) {
+    if (queue->count >= queue->capacity) {
+        TraceLog(LOG_WARNING, "RENDER: Render queue full, dropping item");
+        return;
+    }
+
+    unsigned long long depth = DepthBits(Vector3Distance(queue->camera.position, position));
+    unsigned long long material = ((unsigned long long)PackRenderState(state) << 22) | (shaderId & 0x3FFFFF);
+
+    // Key layout: 2 bits layer | 62 bits ordering within the layer
+    unsigned long long key = (unsigned long long)layer << 62;
+    if (layer == RENDER_LAYER_TRANSPARENT) {
+        // Translucency is order-independent (see oit.h), so only group by material
+        key |= material << 32;
+    } else {
+        // Group by material, then front-to-back to make the most of early depth rejection
+        key |= (material << 32) | (depth >> 2);
+    }
+
+    queue->items[queue->count++] = (RenderItem){
+        .key = key,
+        .layer = layer,
+        .state = state,
+        .shaderId = shaderId,
+        .draw = draw,
+        .data = data
+    };
+}
+
+static int CompareRenderItems(const void* a, const void* b) {
+    unsigned long long keyA = ((const RenderItem*)a)->key;
+    unsigned long long keyB = ((const RenderItem*)b)->key;
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+static bool RenderStatesEqual(RenderState a, RenderState b) {
+    return a.blendMode == b.blendMode && a.depthTest == b.depthTest &&
+           a.depthWrite == b.depthWrite && a.backfaceCulling == b.backfaceCulling;
+}
+
+static void ApplyRenderState(RenderState* current, RenderState next, RenderStats* stats) {
+    if (RenderStatesEqual(*current, next)) return;
+
+    // Pending batched geometry must be drawn with the state it was submitted under
+    rlDrawRenderBatchActive();
+
+    if (current->blendMode != next.blendMode) {
+        BeginBlendMode(next.blendMode);
+        stats->stateChanges++;
+    }
+    if (current->depthTest != next.depthTest) {
+        if (next.depthTest) rlEnableDepthTest(); else rlDisableDepthTest();
+        stats->stateChanges++;
+    }
+    if (current->depthWrite != next.depthWrite) {
+        if (next.depthWrite) rlEnableDepthMask(); else rlDisableDepthMask();
+        stats->stateChanges++;
+    }
+    if (current->backfaceCulling != next.backfaceCulling) {
+        if (next.backfaceCulling) rlEnableBackfaceCulling(); else rlDisableBackfaceCulling();
+        stats->stateChanges++;
+    }
+    *current = next;
+}
+
+void DrawRenderQueueLayer(RenderQueue* queue, RenderLayer layer) {
+    if (!queue->sorted) {
+        qsort(queue->items, queue->count, sizeof(RenderItem), CompareRenderItems);
+        queue->sorted = true;
+    }
+
+    RenderState current = DefaultRenderState();
+    unsigned int currentShader = 0;
+
+    for (int i = 0; i < queue->count; i++) {
+        RenderItem* item = &queue->items[i];
+        if (item->layer != layer) continue;
+
+        ApplyRenderState(&current, item->state, &queue->stats);
+        if (item->shaderId != currentShader) {
+            queue->stats.shaderGroups++;
+            currentShader = item->shaderId;
+        }
+        item->draw(item->data, queue->camera);
+        queue->stats.items++;
+    }
+
+    // Leave the state as BeginMode3D set it up
+    ApplyRenderState(&current, DefaultRenderState(), &queue->stats);
+}
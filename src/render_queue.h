@@ -0,0 +1,65 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <raylib.h>
+#include <stdbool.h>
+#include "arena.h"
+
+#define MAX_RENDER_ITEMS 256
+
+typedef enum {
+    RENDER_LAYER_BACKGROUND,
+    RENDER_LAYER_OPAQUE,
+    RENDER_LAYER_TRANSPARENT    // Drawn into the OIT targets, see oit.h
+} RenderLayer;
+
+typedef struct {
+    int blendMode;          // BlendMode, raylib keeps BLEND_ALPHA active by default
+    bool depthTest;
+    bool depthWrite;
+    bool backfaceCulling;
+} RenderState;
+
+typedef void (*RenderDrawFunc)(void* data, Camera3D camera);
+
+typedef struct {
+    unsigned long long key;     // Sort key: layer, then state/shader and depth
+    RenderLayer layer;
+    RenderState state;
+    unsigned int shaderId;
+    RenderDrawFunc draw;
+    void* data;
+} RenderItem;
+
+// Callbacks bind their own shaders and may issue any number of GL draws, so the
+// queue only counts what it controls: items, the state it applies, and runs of
+// consecutive items sharing a shader after sorting.
+typedef struct {
+    int items;
+    int stateChanges;
+    int shaderGroups;
+} RenderStats;
+
+typedef struct {
+    RenderItem* items;      // Allocated from the frame arena
+    int capacity;
+    int count;
+    Camera3D camera;
+    bool sorted;
+    RenderStats stats;      // Counts since BeginRenderQueue
+} RenderQueue;
+
+// State raylib leaves active inside BeginMode3D
+RenderState DefaultRenderState(void);
+
+// Start collecting items for a frame rendered from camera, with storage from the frame arena
+void BeginRenderQueue(RenderQueue* queue, Camera3D camera, MemArena* frameArena);
+
+// Queue a draw; position is used for depth sorting
+void SubmitRenderItem(RenderQueue* queue, RenderLayer layer, RenderState state, unsigned int shaderId,
+                      Vector3 position, RenderDrawFunc draw, void* data);
+
+// Sort and issue the queued items of one layer, call between BeginMode3D and EndMode3D
+void DrawRenderQueueLayer(RenderQueue* queue, RenderLayer layer);
+
+#endif // RENDER_QUEUE_H
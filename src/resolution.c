@@ -0,0 +1,106 @@
+#include "resolution.h"
+#include <raymath.h>
+#include <rlgl.h>
+#include "arena.h"
+#include <math.h>
+
+#define DYNRES_SMOOTHING 0.1f       // Weight of the newest frame in the moving average
+#define DYNRES_OVER_BUDGET 1.05f    // Scale down once frames are 5% over the target
+#define DYNRES_HEADROOM 0.85f       // Scale up freely once frames are 15% under the target
+#define DYNRES_MAX_STEP 0.1f        // Largest relative change applied in one update
+#define DYNRES_PROBE_DELAY 2.0f     // Seconds on target before probing a higher scale
+#define DYNRES_PROBE_STEP 0.05f
+
+DynamicResolution InitDynamicResolution(int width, int height, float targetFPS) {
+    DynamicResolution dynres = {0};
+    dynres.target = LoadRenderTexture(width, height);
+    SetTextureFilter(dynres.target.texture, TEXTURE_FILTER_BILINEAR);
+    TrackTextureMemory(MEMORY_RENDER, dynres.target.texture);
+    TrackGpuMemory(MEMORY_RENDER, (size_t)width * height * 4);   // 24-bit depth renderbuffer
+    dynres.width = width;
+    dynres.height = height;
+    dynres.scale = DYNRES_MAX_SCALE;
+    dynres.minScale = DYNRES_MIN_SCALE;
+    dynres.maxScale = DYNRES_MAX_SCALE;
+    dynres.targetFrameTime = 1.0f / targetFPS;
+    dynres.smoothedFrameTime = dynres.targetFrameTime;
+    return dynres;
+}
+
+void UpdateDynamicResolution(DynamicResolution* dynres, float frameTime) {
+    // Ignore hitches such as window drags, they say nothing about fill rate
+    frameTime = fminf(frameTime, 4.0f * dynres->targetFrameTime);
+    dynres->smoothedFrameTime = Lerp(dynres->smoothedFrameTime, frameTime, DYNRES_SMOOTHING);
+
+    float target = dynres->targetFrameTime;
+    float smoothed = dynres->smoothedFrameTime;
+    float newScale = dynres->scale;
+
+    if (smoothed > target * DYNRES_OVER_BUDGET || smoothed < target * DYNRES_HEADROOM) {
+        // Fragment cost grows with pixel count, i.e. with the square of the scale
+        float ratio = sqrtf(target / smoothed);
+        ratio = Clamp(ratio, 1.0f - DYNRES_MAX_STEP, 1.0f + DYNRES_MAX_STEP);
+        newScale *= ratio;
+        dynres->onTargetTime = 0.0f;
+    } else {
+        // A frame limiter pins frame time to the target, so headroom is invisible.
+        // Probe upwards now and then; an over-budget frame will pull the scale back.
+        dynres->onTargetTime += frameTime;
+        if (dynres->onTargetTime > DYNRES_PROBE_DELAY) {
+            newScale += DYNRES_PROBE_STEP;
+            dynres->onTargetTime = 0.0f;
+        }
+    }
+
+    newScale = Clamp(newScale, dynres->minScale, dynres->maxScale);
+    if (newScale != dynres->scale) {
+        dynres->scale = newScale;
+        // Restart the average so the next decision only sees frames at the new scale
+        dynres->smoothedFrameTime = target;
+    }
+}
+
+int GetDynamicResolutionWidth(const DynamicResolution* dynres) {
+    int width = (int)(dynres->width * dynres->scale);
+    return width > 0 ? width : 1;
+}
+
+int GetDynamicResolutionHeight(const DynamicResolution* dynres) {
+    int height = (int)(dynres->height * dynres->scale);
+    return height > 0 ? height : 1;
+}
+
+void BeginDynamicResolution(DynamicResolution* dynres) {
+    BeginTextureMode(dynres->target);
+
+    // Render into the lower-left corner only; the aspect ratio stays the same,
+    // so BeginMode3D projections and the 2D ortho projection remain valid
+    rlViewport(0, 0, GetDynamicResolutionWidth(dynres), GetDynamicResolutionHeight(dynres));
+}
+
+void EndDynamicResolution(void) {
+    EndTextureMode();
+}
+
+void DrawDynamicResolution(DynamicResolution* dynres) {
+    // Negative height flips the render texture back to screen orientation. A
+    // scaled-down region is inset by half a texel so bilinear taps at the edges
+    // stay inside it instead of blending in the unused rest of the target; the
+    // full target is copied texel for texel.
+    float width = (float)GetDynamicResolutionWidth(dynres);
+    float height = (float)GetDynamicResolutionHeight(dynres);
+    float inset = (width < dynres->width || height < dynres->height) ? 0.5f : 0.0f;
+    Rectangle source = { inset, inset, width - 2.0f * inset, -(height - 2.0f * inset) };
+    Rectangle dest = { 0.0f, 0.0f, (float)GetScreenWidth(), (float)GetScreenHeight() };
+
+    // The scene is opaque; its alpha channel is a by-product of blending and must not
+    // darken the upscaled image, so copy it without blending
+    rlSetBlendFactors(RL_ONE, RL_ZERO, RL_FUNC_ADD);
+    BeginBlendMode(BLEND_CUSTOM);
+        DrawTexturePro(dynres->target.texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+    EndBlendMode();
+}
+
+void UnloadDynamicResolution(DynamicResolution* dynres) {
+    UnloadRenderTexture(dynres->target);
+}
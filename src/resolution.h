@@ -0,0 +1,41 @@
+#ifndef RESOLUTION_H
+#define RESOLUTION_H
+
+#include <raylib.h>
+
+#define DYNRES_TARGET_FPS 60.0f
+#define DYNRES_MIN_SCALE 0.5f
+#define DYNRES_MAX_SCALE 1.0f
+
+typedef struct {
+    RenderTexture2D target;     // Allocated at full window size, rendered into a sub-rectangle
+    float scale;                // Current render scale per axis
+    float minScale;
+    float maxScale;
+    float targetFrameTime;      // Seconds
+    float smoothedFrameTime;
+    float onTargetTime;         // How long frame times have stayed within the target
+    int width;                  // Full size of the target
+    int height;
+} DynamicResolution;
+
+// Create the off-screen scene target and controller
+DynamicResolution InitDynamicResolution(int width, int height, float targetFPS);
+
+// Feed the last frame time into the controller and adjust the render scale
+void UpdateDynamicResolution(DynamicResolution* dynres, float frameTime);
+
+// Size of the region the scene is currently rendered into
+int GetDynamicResolutionWidth(const DynamicResolution* dynres);
+int GetDynamicResolutionHeight(const DynamicResolution* dynres);
+
+// Redirect rendering to the scaled scene target (call instead of BeginTextureMode)
+void BeginDynamicResolution(DynamicResolution* dynres);
+void EndDynamicResolution(void);
+
+// Upscale the scene target to the full window
+void DrawDynamicResolution(DynamicResolution* dynres);
+
+void UnloadDynamicResolution(DynamicResolution* dynres);
+
+#endif // RESOLUTION_H
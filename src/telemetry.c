@@ -0,0 +1,71 @@
+#include "telemetry.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <raylib.h>
+#include "arena.h"
+
+_Static_assert(MEMORY_SUBSYSTEM_COUNT <= TELEMETRY_MEMORY_SLOTS, "TELEMETRY_MEMORY_SLOTS too small");
+
+Telemetry OpenTelemetry(bool stream) {
+    Telemetry telemetry = { .shmFd = -1, .block = NULL, .socketFd = -1 };
+
+    telemetry.shmFd = shm_open(TELEMETRY_SHM_NAME, O_CREAT | O_RDWR, 0644);
+    if (telemetry.shmFd >= 0 && ftruncate(telemetry.shmFd, sizeof(TelemetryBlock)) == 0) {
+        void* memory = mmap(NULL, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, telemetry.shmFd, 0);
+        if (memory != MAP_FAILED) {
+            telemetry.block = (TelemetryBlock*)memory;
+            memset(telemetry.block, 0, sizeof(TelemetryBlock));
+            telemetry.block->statsSize = sizeof(TelemetryStats);
+        }
+    }
+    if (telemetry.block == NULL) {
+        TraceLog(LOG_WARNING, "TELEMETRY: Failed to map shared memory [%s]: %s", TELEMETRY_SHM_NAME, strerror(errno));
+    }
+
+    if (stream) {
+        telemetry.socketFd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+        if (telemetry.socketFd < 0) {
+            TraceLog(LOG_WARNING, "TELEMETRY: Failed to create socket: %s", strerror(errno));
+        }
+    }
+
+    return telemetry;
+}
+
+void PublishTelemetry(Telemetry* telemetry, const TelemetryStats* stats) {
+    if (telemetry->block != NULL) {
+        // Seqlock write: odd sequence, stats, even sequence. The release fence
+        // keeps the stats stores from moving above the first increment.
+        TelemetryBlock* block = telemetry->block;
+        uint32_t sequence = atomic_load_explicit(&block->sequence, memory_order_relaxed);
+        atomic_store_explicit(&block->sequence, sequence + 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_release);
+        memcpy(&block->stats, stats, sizeof(TelemetryStats));
+        atomic_store_explicit(&block->sequence, sequence + 2, memory_order_release);
+    }
+
+    if (telemetry->socketFd >= 0) {
+        struct sockaddr_un address = { .sun_family = AF_UNIX };
+        strncpy(address.sun_path, TELEMETRY_SOCKET_PATH, sizeof(address.sun_path) - 1);
+
+        // Fails with ENOENT/ECONNREFUSED without a reader and EAGAIN when it
+        // falls behind; both just drop the frame
+        sendto(telemetry->socketFd, stats, sizeof(TelemetryStats), MSG_DONTWAIT,
+               (struct sockaddr*)&address, sizeof(address));
+    }
+}
+
+void CloseTelemetry(Telemetry* telemetry) {
+    if (telemetry->block != NULL) munmap(telemetry->block, sizeof(TelemetryBlock));
+    if (telemetry->shmFd >= 0) {
+        close(telemetry->shmFd);
+        shm_unlink(TELEMETRY_SHM_NAME);
+    }
+    if (telemetry->socketFd >= 0) close(telemetry->socketFd);
+    *telemetry = (Telemetry){ .shmFd = -1, .block = NULL, .socketFd = -1 };
+}
@@ -0,0 +1,56 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+// Shared with tools/telemetry_reader.c, so no raylib types in here
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define TELEMETRY_SHM_NAME "/astropets-telemetry"
+#define TELEMETRY_SOCKET_PATH "/tmp/astropets-telemetry.sock"
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_MEMORY_SLOTS 8        // At least MEMORY_SUBSYSTEM_COUNT
+#define TELEMETRY_NAME_SIZE 12
+
+// Published once per frame. Fixed-size fields only, the layout is the protocol.
+typedef struct {
+    uint32_t version;
+    uint32_t frame;
+    double time;                // Seconds since the window opened
+    float frameTimeMs;
+    float physicsMs;            // Egg and hay simulation of this frame
+    float renderScale;
+    int32_t petCount;
+    int32_t renderItems;        // RenderStats of the scene queue
+    int32_t stateChanges;
+    int32_t shaderGroups;
+    uint32_t memorySlots;       // Used entries below
+    char memoryNames[TELEMETRY_MEMORY_SLOTS][TELEMETRY_NAME_SIZE];
+    uint64_t cpuBytes[TELEMETRY_MEMORY_SLOTS];
+    uint64_t gpuBytes[TELEMETRY_MEMORY_SLOTS];
+} TelemetryStats;
+
+// Shared memory layout. sequence is odd while the engine is writing stats;
+// readers retry until they see the same even value before and after copying.
+typedef struct {
+    _Atomic uint32_t sequence;
+    uint32_t statsSize;         // sizeof(TelemetryStats) of the writer
+    TelemetryStats stats;
+} TelemetryBlock;
+
+typedef struct {
+    int shmFd;
+    TelemetryBlock* block;      // NULL if the segment couldn't be created
+    int socketFd;               // -1 unless streaming
+} Telemetry;
+
+// Create the shared memory segment, and a datagram socket sending to
+// TELEMETRY_SOCKET_PATH if stream is set. Never fails hard, missing parts are skipped.
+Telemetry OpenTelemetry(bool stream);
+
+// Publish a frame's stats without blocking. Datagrams nobody listens for are dropped.
+void PublishTelemetry(Telemetry* telemetry, const TelemetryStats* stats);
+
+void CloseTelemetry(Telemetry* telemetry);
+
+#endif // TELEMETRY_H
@@ -1,15 +1,14 @@
 #include "terrarium.h"
 #include "rlgl.h"
 #include "constants.h"
+#include "arena.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-static Mesh GenerateGroundMesh(float sphereRadius) {
+Mesh GenerateGroundMesh(float sphereRadius, int rings, int slices) {
     float groundRadius = sqrtf(sphereRadius * sphereRadius - 1.0f); // Width at y=0
-    const int rings = 32;
-    const int slices = 32;
 
     // Vertex and index counts
     int curvedVertexCount = (rings / 2 + 1) * (slices + 1); // Include seam duplication
@@ -127,7 +126,6 @@ static Mesh GenerateGroundMesh(float sphereRadius) {
     // Finalize mesh
     mesh.vertexCount = totalVertexCount;
     mesh.triangleCount = totalTriangleCount;
-    UploadMesh(&mesh, false);
     return mesh;
 }
 
@@ -141,9 +139,6 @@ Shader LoadGlassShader(const char* vertexFile, const char* fragmentFile) {
     int normalStrengthLoc = GetShaderLocation(shader, "normalStrength");
     int lightDirLoc = GetShaderLocation(shader, "lightDir");
     int normalMatrixLoc = GetShaderLocation(shader, "matNormal");
-    int internalLightPosLoc = GetShaderLocation(shader, "internalLightPos");
-    int internalLightColorLoc = GetShaderLocation(shader, "internalLightColor");
-    int internalLightIntensityLoc = GetShaderLocation(shader, "internalLightIntensity");
 
     // Further modified values for more transparency and brightness
     float albedoColor[4] = {1.0f, 1.0f, 1.0f, 0.1f};  // Much more transparent base color
@@ -151,9 +146,6 @@ Shader LoadGlassShader(const char* vertexFile, const char* fragmentFile) {
     float roughnessValue = 0.02f;                         // Even smoother surface
     float normalStrength = 1.0f;                         
     float lightDir[3] = {-0.5f, 1.0f, -0.5f};           
-    float internalLightPos[3] = {0.0f, 1.8f, 0.0f};     
-    float internalLightColor[3] = {1.0f, 1.0f, 1.0f};    // Pure white light for maximum brightness
-    float internalLightIntensity = 12.0f;                 // Significantly increased light intensity
 
     Matrix normalMatrix = MatrixIdentity();
 
@@ -163,9 +155,6 @@ Shader LoadGlassShader(const char* vertexFile, const char* fragmentFile) {
     SetShaderValue(shader, normalStrengthLoc, &normalStrength, SHADER_UNIFORM_FLOAT);
     SetShaderValue(shader, lightDirLoc, lightDir, SHADER_UNIFORM_VEC3);
     SetShaderValueMatrix(shader, normalMatrixLoc, normalMatrix);
-    SetShaderValue(shader, internalLightPosLoc, internalLightPos, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, internalLightColorLoc, internalLightColor, SHADER_UNIFORM_VEC3);
-    SetShaderValue(shader, internalLightIntensityLoc, &internalLightIntensity, SHADER_UNIFORM_FLOAT);
 
     return shader;
 }
@@ -184,7 +173,8 @@ static GlassSphere InitializeGlassSphere(Shader glassShader) {
 // Initialize the ground
 static Ground InitializeGround(Shader groundShader, float sphereRadius) {
     Ground ground = {0};
-    Mesh groundMesh = GenerateGroundMesh(sphereRadius);
+    Mesh groundMesh = GenerateGroundMesh(sphereRadius, GROUND_RINGS, GROUND_SLICES);
+    UploadMesh(&groundMesh, false);
     ground.surface = LoadModelFromMesh(groundMesh);
     ground.height = 0.0f;  // Place at origin
     ground.shader = groundShader;
@@ -197,35 +187,67 @@ TerrariumSystem InitializeTerrariumSystem(Shader glassShader, Shader groundShade
     TerrariumSystem terrarium = {0};
     terrarium.glass = InitializeGlassSphere(glassShader);
     terrarium.ground = InitializeGround(groundShader, 2.0f);
+    TrackModelMemory(MEMORY_TERRARIUM, terrarium.glass.sphere);
+    TrackModelMemory(MEMORY_TERRARIUM, terrarium.ground.surface);
 
-    // Initialize internal light
-    terrarium.internalLight = CreateLight(
-        (Vector3){0.0f, 2.5f, 0.0f},  // Position above the sphere
+    // Lights are culled into tiles of the full-size render target
+    terrarium.lights = CreateLightList(GetScreenWidth(), GetScreenHeight());
+
+    // Initialize internal light, high inside the sphere
+    terrarium.internalLight = AddLight(&terrarium.lights, CreateLight(
+        (Vector3){0.0f, terrarium.glass.position.y + 1.5f, 0.0f},
         (Vector3){1.0f, 1.0f, 1.0f},  // White light
-        8.0f                          // Intensity
-    );
+        8.0f,                         // Intensity
+        8.0f                          // Range, reaches the bottom of the sphere
+    ));
+
+    BindTerrariumLights(&terrarium, terrarium.glass.shader);
+    BindTerrariumLights(&terrarium, terrarium.ground.shader);
 
     return terrarium;
 }
 
+void BindTerrariumLights(TerrariumSystem* terrarium, Shader shader) {
+    BindLightList(&terrarium->lights, shader);
+}
+
+void EnableTerrariumLights(TerrariumSystem* terrarium) {
+    EnableLightList(&terrarium->lights);
+}
+
+void DisableTerrariumLights(void) {
+    DisableLightList();
+}
+
+void UpdateTerrariumLights(TerrariumSystem* terrarium, Camera3D camera, int width, int height, MemArena* scratch) {
+    UpdateLightList(&terrarium->lights, camera, width, height, scratch);
+}
+
 void UpdateTerrariumLight(TerrariumSystem* terrarium, Vector3 color, float intensity) {
-    UpdateLight(&terrarium->internalLight, terrarium->internalLight.position, color, intensity);
+    LightComponent* light = &terrarium->lights.lights[terrarium->internalLight];
+    UpdateLight(light, light->position, color, intensity);
 }
-void DrawTerrariumSystem(TerrariumSystem* terrarium, Camera3D camera) {
-    // Disable backface culling for the ground
-    rlDisableBackfaceCulling();
+static void DrawGroundItem(void* data, Camera3D camera) {
+    (void)camera;
+    TerrariumSystem* terrarium = (TerrariumSystem*)data;
 
     // Draw the ground at the glass sphere's position but offset slightly lower
     Vector3 groundPosition = terrarium->glass.position;
     groundPosition.y -= 0.9f; // Offset by -1 to place the top edge at y=0
     DrawModel(terrarium->ground.surface, groundPosition, 1.0f, WHITE);
     DrawModelWires(terrarium->ground.surface, groundPosition, 1.0f, RED);
+}
 
-    // Re-enable backface culling for other objects
-    rlEnableBackfaceCulling();
+static void DrawLightMarkerItem(void* data, Camera3D camera) {
+    (void)camera;
+    TerrariumSystem* terrarium = (TerrariumSystem*)data;
 
-    // Enable blending for the glass material
-    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    // Draw a small sphere to represent the internal light source
+    DrawSphere(terrarium->lights.lights[terrarium->internalLight].position, 0.1f, YELLOW);
+}
+
+static void DrawGlassItem(void* data, Camera3D camera) {
+    TerrariumSystem* terrarium = (TerrariumSystem*)data;
 
     // Update shader uniforms for the glass sphere
     float cameraPos[3] = {camera.position.x, camera.position.y, camera.position.z};
@@ -242,38 +264,31 @@ void DrawTerrariumSystem(TerrariumSystem* terrarium, Camera3D camera) {
     int normalMatrixLoc = GetShaderLocation(terrarium->glass.shader, "matNormal");
     SetShaderValueMatrix(terrarium->glass.shader, normalMatrixLoc, normalMatrix);
 
-    // Update internal light position relative to the sphere
-    Vector3 internalLightPos = {
-        terrarium->glass.position.x,
-        terrarium->glass.position.y + 1.5f, // Moved higher inside the sphere
-        terrarium->glass.position.z
-    };
-    float lightPos[3] = {internalLightPos.x, internalLightPos.y, internalLightPos.z};
-    int internalLightPosLoc = GetShaderLocation(terrarium->glass.shader, "internalLightPos");
-    SetShaderValue(terrarium->glass.shader, internalLightPosLoc, lightPos, SHADER_UNIFORM_VEC3);
-
-    // Update internal light color and intensity
-    float lightColor[3] = {
-        terrarium->internalLight.color.x,
-        terrarium->internalLight.color.y,
-        terrarium->internalLight.color.z
-    };
-    int internalLightColorLoc = GetShaderLocation(terrarium->glass.shader, "internalLightColor");
-    int internalLightIntensityLoc = GetShaderLocation(terrarium->glass.shader, "internalLightIntensity");
-    SetShaderValue(terrarium->glass.shader, internalLightColorLoc, lightColor, SHADER_UNIFORM_VEC3);
-    SetShaderValue(terrarium->glass.shader, internalLightIntensityLoc, &terrarium->internalLight.intensity, SHADER_UNIFORM_FLOAT);
-
-    // Draw a small sphere to represent the internal light source
-    DrawSphere(internalLightPos, 0.1f, YELLOW);
-
     // Draw the glass sphere
     DrawModel(terrarium->glass.sphere, terrarium->glass.position, 1.0f, WHITE);
+}
 
-    // Disable blending after drawing the glass sphere
-    EndBlendMode();
+void SubmitTerrariumSystem(TerrariumSystem* terrarium, RenderQueue* queue) {
+    // The ground is seen from below through the glass, so it is drawn double-sided
+    RenderState groundState = DefaultRenderState();
+    groundState.backfaceCulling = false;
+    SubmitRenderItem(queue, RENDER_LAYER_OPAQUE, groundState, terrarium->ground.shader.id,
+                     terrarium->glass.position, DrawGroundItem, terrarium);
+
+    SubmitRenderItem(queue, RENDER_LAYER_OPAQUE, DefaultRenderState(), rlGetShaderIdDefault(),
+                     terrarium->lights.lights[terrarium->internalLight].position, DrawLightMarkerItem, terrarium);
+
+    // Blend factors for the accumulation targets are set by BeginOIT
+    RenderState glassState = DefaultRenderState();
+    glassState.blendMode = BLEND_CUSTOM_SEPARATE;
+    glassState.depthWrite = false;
+    SubmitRenderItem(queue, RENDER_LAYER_TRANSPARENT, glassState, terrarium->glass.shader.id,
+                     terrarium->glass.position, DrawGlassItem, terrarium);
 }
+
 // Unload resources
 void UnloadTerrariumSystem(TerrariumSystem* terrarium) {
     UnloadModel(terrarium->glass.sphere);
     UnloadModel(terrarium->ground.surface);
+    UnloadLightList(&terrarium->lights);
 }
\ No newline at end of file
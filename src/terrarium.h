@@ -4,6 +4,12 @@
 #include <raylib.h>
 #include <raymath.h>
 #include "light.h"
+#include "render_queue.h"
+#include "arena.h"
+
+#define GROUND_RINGS 32
+#define GROUND_SLICES 32
+
 typedef struct {
     Model sphere;
     float radius;
@@ -20,11 +26,20 @@ typedef struct {
 typedef struct {
     GlassSphere glass;
     Ground ground;
-    LightComponent internalLight;
+    LightList lights;
+    int internalLight;  // Index into lights
 } TerrariumSystem;
 
+// Build the ground bowl on the CPU, without uploading it. rings must be even and
+// (rings / 2 + 1) * (slices + 1) + slices + 1 below 65536 for 16-bit indices.
+Mesh GenerateGroundMesh(float sphereRadius, int rings, int slices);
+
 TerrariumSystem InitializeTerrariumSystem(Shader glassShader, Shader groundShader);
-void DrawTerrariumSystem(TerrariumSystem* terrarium, Camera3D camera);
+void BindTerrariumLights(TerrariumSystem* terrarium, Shader shader);
+void EnableTerrariumLights(TerrariumSystem* terrarium);
+void DisableTerrariumLights(void);
+void UpdateTerrariumLights(TerrariumSystem* terrarium, Camera3D camera, int width, int height, MemArena* scratch);
+void SubmitTerrariumSystem(TerrariumSystem* terrarium, RenderQueue* queue);
 void UnloadTerrariumSystem(TerrariumSystem* terrarium);
 
 #endif // TERRARIUM_H
\ No newline at end of file
@@ -0,0 +1,144 @@
+// Prints the engine's live telemetry, one line per sample.
+// Usage: telemetry_reader [--interval ms] [--count n] [--socket]
+//   default:  poll the shared memory block every interval (100 ms)
+//   --socket: receive every frame's datagram on TELEMETRY_SOCKET_PATH instead
+
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "telemetry.h"
+
+static volatile sig_atomic_t running = 1;
+
+static void StopReader(int signum) {
+    running = 0;
+}
+
+#define READ_ATTEMPTS 1000     // Gives up if the engine died mid-write
+
+// Seqlock read: retry while a write is in progress or happened during the copy
+static bool ReadTelemetry(TelemetryBlock* block, TelemetryStats* stats) {
+    for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+        uint32_t before = atomic_load_explicit(&block->sequence, memory_order_acquire);
+        if (before == 0) return false;
+        if (before & 1) continue;
+
+        memcpy(stats, &block->stats, sizeof(TelemetryStats));
+        atomic_thread_fence(memory_order_acquire);
+
+        uint32_t after = atomic_load_explicit(&block->sequence, memory_order_relaxed);
+        if (before == after) return true;
+    }
+    return false;
+}
+
+static void PrintStats(const TelemetryStats* stats) {
+    uint64_t cpuBytes = 0;
+    uint64_t gpuBytes = 0;
+    for (uint32_t i = 0; i < stats->memorySlots && i < TELEMETRY_MEMORY_SLOTS; i++) {
+        cpuBytes += stats->cpuBytes[i];
+        gpuBytes += stats->gpuBytes[i];
+    }
+
+    printf("frame %7u  t %8.2f s  frame %6.2f ms  physics %6.3f ms  pets %d  scale %3d%%  "
+           "items %3d  states %3d  shaders %2d  cpu %8.1f KB  gpu %8.1f KB\n",
+           stats->frame, stats->time, stats->frameTimeMs, stats->physicsMs, stats->petCount,
+           (int)(stats->renderScale * 100.0f), stats->renderItems, stats->stateChanges, stats->shaderGroups,
+           cpuBytes / 1024.0, gpuBytes / 1024.0);
+    fflush(stdout);
+}
+
+static int ReadSharedMemory(int intervalMs, int count) {
+    int fd = -1;
+    while (running && (fd = shm_open(TELEMETRY_SHM_NAME, O_RDONLY, 0)) < 0) {
+        fprintf(stderr, "telemetry_reader: waiting for %s\n", TELEMETRY_SHM_NAME);
+        sleep(1);
+    }
+    if (fd < 0) return 0;
+
+    TelemetryBlock* block = mmap(NULL, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (block == MAP_FAILED) {
+        perror("telemetry_reader: mmap");
+        return 1;
+    }
+    if (block->statsSize != 0 && block->statsSize != sizeof(TelemetryStats)) {
+        fprintf(stderr, "telemetry_reader: stats size %u, expected %zu\n", block->statsSize, sizeof(TelemetryStats));
+        munmap(block, sizeof(TelemetryBlock));
+        return 1;
+    }
+
+    uint32_t lastFrame = UINT32_MAX;
+    for (int samples = 0; running && (count <= 0 || samples < count); ) {
+        TelemetryStats stats;
+        if (ReadTelemetry(block, &stats) && stats.frame != lastFrame) {
+            PrintStats(&stats);
+            lastFrame = stats.frame;
+            samples++;
+        }
+        usleep((useconds_t)intervalMs * 1000);
+    }
+
+    munmap(block, sizeof(TelemetryBlock));
+    return 0;
+}
+
+static int ReadSocket(int count) {
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        perror("telemetry_reader: socket");
+        return 1;
+    }
+
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    strncpy(address.sun_path, TELEMETRY_SOCKET_PATH, sizeof(address.sun_path) - 1);
+    unlink(TELEMETRY_SOCKET_PATH);
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        perror("telemetry_reader: bind");
+        close(fd);
+        return 1;
+    }
+
+    for (int samples = 0; running && (count <= 0 || samples < count); ) {
+        TelemetryStats stats;
+        ssize_t size = recv(fd, &stats, sizeof(stats), 0);
+        if (size == (ssize_t)sizeof(stats) && stats.version == TELEMETRY_VERSION) {
+            PrintStats(&stats);
+            samples++;
+        }
+    }
+
+    close(fd);
+    unlink(TELEMETRY_SOCKET_PATH);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    int intervalMs = 100;
+    int count = 0;
+    bool useSocket = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+            intervalMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc) {
+            count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--socket") == 0) {
+            useSocket = true;
+        }
+    }
+    if (intervalMs < 1) intervalMs = 1;
+
+    // No SA_RESTART, so Ctrl+C also interrupts a blocking recv
+    struct sigaction action = { .sa_handler = StopReader };
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    return useSocket ? ReadSocket(count) : ReadSharedMemory(intervalMs, count);
+}